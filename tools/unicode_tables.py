@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# generates the XID_Start/XID_Continue lookup tables in zay/src/zay/scan/Unicode.cpp
+# python's str.isidentifier follows the XID properties (plus '_') of the unicode version it ships with
+# usage: python3 tools/unicode_tables.py
+import os
+import sys
+import unicodedata
+
+BLOCK_BITS = 8
+BLOCK_SIZE = 1 << BLOCK_BITS
+BEGIN_MARKER = "\t// BEGIN GENERATED TABLES\n"
+END_MARKER = "\t// END GENERATED TABLES\n"
+
+def is_surrogate(cp):
+	return 0xD800 <= cp <= 0xDFFF
+
+def block_bits(block):
+	start = 0
+	cont = 0
+	for i in range(BLOCK_SIZE):
+		cp = block * BLOCK_SIZE + i
+		if is_surrogate(cp):
+			continue
+		c = chr(cp)
+		if c.isidentifier():
+			start |= 1 << i
+		if ("a" + c).isidentifier():
+			cont |= 1 << i
+	return (start, cont)
+
+def words(bits):
+	return [(bits >> (64 * i)) & 0xFFFFFFFFFFFFFFFF for i in range(BLOCK_SIZE // 64)]
+
+def generate():
+	blocks = []
+	unique = {}
+	last = 0
+	for block in range(0x110000 // BLOCK_SIZE):
+		bits = block_bits(block)
+		if bits != (0, 0):
+			last = block
+		if bits not in unique:
+			unique[bits] = len(unique)
+		blocks.append(unique[bits])
+	blocks = blocks[:last + 1]
+	assert len(unique) < 256
+
+	out = []
+	out.append("\t// generated from the unicode %s XID_Start and XID_Continue properties\n" % unicodedata.unidata_version)
+	out.append("\tconstexpr size_t XID_BLOCK_BITS = %d;\n" % BLOCK_BITS)
+	out.append("\tconstexpr size_t XID_BLOCKS_COUNT = %d;\n\n" % len(blocks))
+	out.append("\t// index of the bits of each block of %d runes in XID_BITS\n" % BLOCK_SIZE)
+	out.append("\tstatic const uint8_t XID_BLOCKS[XID_BLOCKS_COUNT] = {\n")
+	for i in range(0, len(blocks), 16):
+		out.append("\t\t" + ", ".join("%d" % b for b in blocks[i:i + 16]) + ",\n")
+	out.append("\t};\n\n")
+	out.append("\t// the first 4 words are the XID_Start bits of the block, the last 4 are the XID_Continue bits\n")
+	out.append("\tstatic const uint64_t XID_BITS[%d][8] = {\n" % len(unique))
+	for (start, cont) in sorted(unique, key=lambda k: unique[k]):
+		out.append("\t\t{" + ", ".join("0x%016X" % w for w in words(start) + words(cont)) + "},\n")
+	out.append("\t};\n")
+	return "".join(out)
+
+def main():
+	root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+	path = os.path.join(root, "zay", "src", "zay", "scan", "Unicode.cpp")
+	with open(path, "r", newline="") as f:
+		code = f.read()
+	begin = code.index(BEGIN_MARKER) + len(BEGIN_MARKER)
+	end = code.index(END_MARKER)
+	code = code[:begin] + generate() + code[end:]
+	with open(path, "w", newline="") as f:
+		f.write(code)
+
+if __name__ == "__main__":
+	sys.exit(main())
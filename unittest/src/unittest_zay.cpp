@@ -4,8 +4,16 @@
 #include <zay/scan/Scanner.h>
 #include <zay/parse/Parser.h>
 #include <zay/parse/AST_Lisp.h>
+#include <zay/parse/AST_Cache.h>
 #include <zay/typecheck/Typer.h>
 #include <zay/CGen.h>
+#include <zay/Small_Buf.h>
+
+#include <mn/Thread.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
 
 inline static mn::Str
 scan(const char* str)
@@ -36,7 +44,6 @@ parse_expr(const char* str)
 
 	auto parser = zay::parser_new(src);
 	auto e = zay::parser_expr(parser);
-	zay::parser_free(parser);
 
 	auto out = mn::memory_stream_new(mn::memory::tmp());
 	auto writer = zay::ast_lisp_new(out);
@@ -56,7 +63,6 @@ parse_stmt(const char* str)
 
 	auto parser = zay::parser_new(src);
 	auto s = zay::parser_stmt(parser);
-	zay::parser_free(parser);
 
 	auto out = mn::memory_stream_new(mn::memory::tmp());
 	auto writer = zay::ast_lisp_new(out);
@@ -68,6 +74,29 @@ parse_stmt(const char* str)
 	return res;
 }
 
+inline static mn::Str
+trivia_dump(zay::Src* src)
+{
+	auto out = mn::memory_stream_new(mn::memory::tmp());
+	for(const zay::Trivia& t: src->tkns.trivia)
+	{
+		const char* it = src->content.ptr + t.offset;
+		mn::print_to(out, "{}: {}\n", t.offset, mn::str_from_substr(it, it + t.len, mn::memory::tmp()));
+	}
+	return mn::memory_stream_str(out);
+}
+
+inline static mn::Str
+scan_trivia(const char* str, size_t chunks_count)
+{
+	auto src = zay::src_from_str(str);
+	src->comments = zay::COMMENTS::TRIVIA;
+	CHECK(zay::src_scan_chunked(src, chunks_count));
+	auto res = trivia_dump(src);
+	zay::src_free(src);
+	return res;
+}
+
 TEST_CASE("[zay]: scan basic comment")
 {
 	const char* code = R"CODE(//type foo struct{}
@@ -150,6 +179,271 @@ line: 10, col: 1, kind: "}" str: "}"
 	CHECK(answer == expected);
 }
 
+TEST_CASE("[zay]: scan escaped string")
+{
+	const char* code = R"CODE(var x = "say \"hi\"\\";
+var y = "multi
+line";
+)CODE";
+
+	const char* expected = R"EXPECTED(line: 1, col: 0, kind: "var" str: "var"
+line: 1, col: 4, kind: "<ID>" str: "x"
+line: 1, col: 6, kind: "=" str: "="
+line: 1, col: 8, kind: "<STRING>" str: ""say \"hi\"\\""
+line: 1, col: 22, kind: ";" str: ";"
+line: 2, col: 1, kind: "var" str: "var"
+line: 2, col: 5, kind: "<ID>" str: "y"
+line: 2, col: 7, kind: "=" str: "="
+line: 2, col: 9, kind: "<STRING>" str: ""multi
+line""
+line: 3, col: 6, kind: ";" str: ";"
+)EXPECTED";
+
+	auto answer = scan(code);
+	CHECK(answer == expected);
+}
+
+TEST_CASE("[zay]: scan edits")
+{
+	auto src = zay::src_from_str(R"CODE(var x: int = 234;
+var y = x + 1;
+)CODE");
+	CHECK(zay::src_scan(src));
+
+	//rename x to xyz in the first line
+	CHECK(zay::src_edit(src, 5, 5, "yz", 2));
+	//open a string which swallows the rest of the code
+	CHECK(zay::src_edit(src, 20, 20, "\"", 1) == false);
+	//close it again
+	CHECK(zay::src_edit(src, 20, 21, "", 0));
+
+	const char* expected = R"CODE(var xyz: int = 234;
+var y = x + 1;
+)CODE";
+	CHECK(zay::src_tkns_dump(src, mn::memory::tmp()) == scan(expected));
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: src pos from pointer")
+{
+	const char* code = R"CODE(type foo struct{
+	x, y: int;
+}
+
+//comment
+var x: int = "multi
+line";)CODE";
+
+	auto src = zay::src_from_str(code);
+	auto scanner = zay::scanner_new(src);
+	size_t count = 0;
+	while(zay::Tkn t = zay::scanner_tkn(&scanner))
+	{
+		zay::Pos pos = zay::src_pos(src, t.rng.begin);
+		CHECK(pos.line == t.pos.line);
+		CHECK(pos.col == t.pos.col);
+		++count;
+	}
+	CHECK(count == 19);
+	CHECK(src->lines.count == 7);
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: scan borrowed buffer")
+{
+	//only the first statement is in the buffer
+	const char* code = "var x = 1; var y = 2;";
+
+	auto src = zay::src_from_buffer(code, 10);
+	CHECK(zay::src_scan(src));
+	auto answer = zay::src_tkns_dump(src, mn::memory::tmp());
+	CHECK(src->content.ptr == code);
+	zay::src_free(src);
+
+	CHECK(answer == scan("var x = 1;"));
+}
+
+TEST_CASE("[zay]: scan chunks")
+{
+	const char* code = R"CODE(type foo struct{
+	x, y: int;
+}
+
+//the chunks split right after newlines
+var s = "this string
+spans
+multiple
+lines";
+
+func add(x, y: int): int {
+	return x + y;
+}
+var x = 0x;
+)CODE";
+
+	auto sequential = zay::src_from_str(code);
+	CHECK(zay::src_scan(sequential) == false);
+	auto expected_tkns = zay::src_tkns_dump(sequential, mn::memory::tmp());
+	auto expected_errs = zay::src_errs_dump(sequential, mn::memory::tmp());
+	zay::src_free(sequential);
+
+	for(size_t chunks_count = 1; chunks_count < 16; ++chunks_count)
+	{
+		auto src = zay::src_from_str(code);
+		CHECK(zay::src_scan_chunked(src, chunks_count) == false);
+		CHECK(zay::src_tkns_dump(src, mn::memory::tmp()) == expected_tkns);
+		CHECK(zay::src_errs_dump(src, mn::memory::tmp()) == expected_errs);
+		zay::src_free(src);
+	}
+}
+
+TEST_CASE("[zay]: scan comments as trivia")
+{
+	const char* code = R"CODE(//first
+type foo struct{ //after a token
+	x, y: int;
+}
+var s = "not // a comment";
+//last)CODE";
+
+	auto src = zay::src_from_str(code);
+	src->comments = zay::COMMENTS::TRIVIA;
+	CHECK(zay::src_scan(src));
+	CHECK(zay::tkn_store_count(src->tkns) == 16);
+	for(size_t i = 0; i < zay::tkn_store_count(src->tkns); ++i)
+		CHECK(src->tkns.kinds[i] != zay::Tkn::KIND_COMMENT);
+
+	//move the code after the first comment one line down and comment out the x, y line
+	CHECK(zay::src_edit(src, 7, 7, "\n", 1));
+	CHECK(zay::src_edit(src, 43, 43, "//", 2));
+	CHECK(zay::src_edit(src, 8, 8, "//new\n", 6));
+	auto edited = mn::str_from_substr(src->content.ptr, src->content.ptr + src->content.count, mn::memory::tmp());
+	CHECK(trivia_dump(src) == scan_trivia(edited.ptr, 1));
+	zay::src_free(src);
+
+	const char* expected = R"EXPECTED(0: //first
+25: //after a token
+83: //last
+)EXPECTED";
+
+	for(size_t chunks_count = 1; chunks_count < 8; ++chunks_count)
+		CHECK(scan_trivia(code, chunks_count) == expected);
+}
+
+TEST_CASE("[zay]: scan unicode ids")
+{
+	//a combining accent and an arabic indic digit can't begin an id but they can continue one
+	auto src = zay::src_from_str("var cafe\xCC\x81 = x\xD9\xA3; var \xE5\x90\x8D\xE5\x89\x8D = 1");
+	CHECK(zay::src_scan(src));
+	CHECK(zay::tkn_store_count(src->tkns) == 9);
+	CHECK(::strcmp(zay::src_tkn_at(src, 1).str, "cafe\xCC\x81") == 0);
+	CHECK(::strcmp(zay::src_tkn_at(src, 3).str, "x\xD9\xA3") == 0);
+	CHECK(::strcmp(zay::src_tkn_at(src, 6).str, "\xE5\x90\x8D\xE5\x89\x8D") == 0);
+	zay::src_free(src);
+
+	//an overlong encoding of / inside a string
+	src = zay::src_from_str("var x = 1;\nvar s = \"\xC0\xAF\";");
+	CHECK(zay::src_scan(src) == false);
+	CHECK(src->errs.count == 1);
+	CHECK(src->errs[0].pos.line == 2);
+	zay::src_free(src);
+}
+
+inline static void
+intern_worker(void* arg)
+{
+	auto res = (const char**)arg;
+	char name[32];
+	for(size_t i = 0; i < 1000; ++i)
+	{
+		::snprintf(name, sizeof(name), "name_%zu", i);
+		res[i] = zay::intern_pool_get(zay::intern_pool_global(), name);
+	}
+}
+
+TEST_CASE("[zay]: intern pool")
+{
+	//the same id in different compilation units is the same pointer
+	auto a = zay::src_from_str("var shared_name = 1");
+	auto b = zay::src_from_str("func f() { shared_name = 2 }");
+	CHECK(zay::src_scan(a));
+	CHECK(zay::src_scan(b));
+	CHECK(zay::src_tkn_at(a, 1).str == zay::src_tkn_at(b, 5).str);
+	zay::src_free(a);
+	zay::src_free(b);
+
+	const char* results[4][1000];
+	mn::Thread threads[4];
+	for(size_t i = 0; i < 4; ++i)
+		threads[i] = mn::thread_new(intern_worker, results[i], "intern worker");
+	for(size_t i = 0; i < 4; ++i)
+	{
+		mn::thread_join(threads[i]);
+		mn::thread_free(threads[i]);
+	}
+
+	for(size_t i = 0; i < 1000; ++i)
+	{
+		CHECK(results[0][i] == results[1][i]);
+		CHECK(results[0][i] == results[2][i]);
+		CHECK(results[0][i] == results[3][i]);
+	}
+	CHECK(::strcmp(results[0][999], "name_999") == 0);
+}
+
+TEST_CASE("[zay]: scan literal values")
+{
+	auto src = zay::src_from_str(R"CODE(0x1F 0b101 0d99 18446744073709551615 2.5e3 "a\tb\x41\0")CODE");
+	CHECK(zay::src_scan(src));
+
+	//every literal has one value and scanning the code again doesn't add more
+	CHECK(src->tkns.values.count == 6);
+	auto scanner = zay::scanner_new(src);
+	while(zay::scanner_tkn(&scanner))
+		continue;
+	CHECK(src->tkns.values.count == 6);
+
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 0)).integer == 31);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 1)).integer == 5);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 2)).integer == 99);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 3)).integer == UINT64_MAX);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 4)).real == 2500.0);
+	auto str = zay::src_tkn_value(src, zay::src_tkn_at(src, 5));
+	CHECK(str.count == 5);
+	CHECK(::memcmp(str.string, "a\tbA\0", 5) == 0);
+
+	//the chunked scan and the edits keep the values in step with the tokens
+	for(size_t chunks_count = 2; chunks_count < 8; ++chunks_count)
+	{
+		auto chunked = zay::src_from_str(src->content.ptr);
+		CHECK(zay::src_scan_chunked(chunked, chunks_count));
+		CHECK(chunked->tkns.values.count == 6);
+		CHECK(zay::src_tkn_value(chunked, zay::src_tkn_at(chunked, 3)).integer == UINT64_MAX);
+		zay::src_free(chunked);
+	}
+	CHECK(zay::src_edit(src, 0, 4, "7 0d8", 5));
+	CHECK(src->tkns.values.count == 7);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 0)).integer == 7);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 1)).integer == 8);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 2)).integer == 5);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 5)).real == 2500.0);
+	CHECK(zay::src_tkn_value(src, zay::src_tkn_at(src, 6)).count == 5);
+	zay::src_free(src);
+
+	//the other C escapes are decoded too and the unknown ones are left to the C compiler
+	src = zay::src_from_str(R"CODE("\101\?\e\u00e9\U0001F600\q\x4\uD800")CODE");
+	CHECK(zay::src_scan(src));
+	str = zay::src_tkn_value(src, zay::src_tkn_at(src, 0));
+	CHECK(str.count == 18);
+	CHECK(::memcmp(str.string, "A?\x1B\xC3\xA9\xF0\x9F\x98\x80\\q\x04\\uD800", 18) == 0);
+	zay::src_free(src);
+
+	src = zay::src_from_str(R"CODE(18446744073709551616 "\q")CODE");
+	CHECK(zay::src_scan(src) == false);
+	CHECK(src->errs.count == 1);
+	zay::src_free(src);
+}
+
 TEST_CASE("[zay]: parse basic struct")
 {
 	const char* code = R"CODE(type foo struct{
@@ -319,6 +613,27 @@ TEST_CASE("[zay]: parse add mul expression")
 	CHECK(answer == expected);
 }
 
+TEST_CASE("[zay]: parse binary precedence")
+{
+	CHECK(parse_expr("a || b && c < d + e * f - g") == "(binary || (atom a) (binary && (atom b) (binary < (atom c) (binary - (binary + (atom d) (binary * (atom e) (atom f))) (atom g)))))");
+	CHECK(parse_expr("a - b - c || d") == "(binary || (binary - (binary - (atom a) (atom b)) (atom c)) (atom d))");
+	//comparisons don't chain so the expression ends before the second one
+	CHECK(parse_expr("a < b < c") == "(binary < (atom a) (atom b))");
+	CHECK(parse_expr("a && b < c < d") == "(binary && (atom a) (binary < (atom b) (atom c)))");
+
+	//long left associative chains are folded in a loop, this shouldn't grow the stack
+	auto code = mn::str_tmp();
+	code = mn::strf(code, "func f(a: int): int {{ return a");
+	for(size_t i = 0; i < 100000; ++i)
+		code = mn::strf(code, " + a");
+	code = mn::strf(code, " }}");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan(src));
+	CHECK(zay::src_parse(src, zay::MODE::NONE));
+	zay::src_free(src);
+}
+
 TEST_CASE("[zay]: complex dereference returned pointer")
 {
 	const char* code = "*arr[v.x + b * c[123]].koko(z: float32, w)";
@@ -477,6 +792,545 @@ TEST_CASE("[zay]: composite literal")
 	CHECK(answer == expected);
 }
 
+TEST_CASE("[zay]: parse streamed tokens")
+{
+	const char* code = R"CODE(//uses Point before its declaration
+func origin(): Point {
+	return Point{x: 0, y: 0}
+}
+
+type Point struct {
+	x, y: int
+}
+)CODE";
+
+	auto src = zay::src_from_str(code);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(zay::tkn_store_count(src->tkns) == 0);
+	auto answer = zay::src_ast_dump(src, mn::memory::tmp());
+	zay::src_free(src);
+
+	CHECK(answer == parse(code));
+
+	//the var declaration ends before the '{' until it's known that Point is a type
+	const char* forward = R"CODE(var p = Point{x: 1, y: 2}
+func main() {
+}
+type Point struct {
+	x, y: int
+}
+)CODE";
+
+	src = zay::src_from_str(forward);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(src->ast.decls.count == 3);
+	answer = zay::src_ast_dump(src, mn::memory::tmp());
+	zay::src_free(src);
+
+	CHECK(answer == parse(forward));
+
+	//a token which doesn't begin a declaration is an error instead of the end of the code
+	src = zay::src_from_str("var x = 1\n}\nfunc main() {\n}\n");
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE) == false);
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: parse stored tokens positions")
+{
+	const char* code = R"CODE(type foo struct{
+	x, y: int
+}
+
+//comment ÿ
+func f(a: foo): int { return a.x + 1 }
+var x: string = "multi
+line"
+var y: int = 2)CODE";
+
+	auto src = zay::src_from_str(code);
+	auto scanner = zay::scanner_new(src);
+	auto scanned = mn::buf_new<zay::Pos>();
+	mn_defer(mn::buf_free(scanned));
+	while(zay::Tkn t = zay::scanner_tkn(&scanner))
+		mn::buf_push(scanned, t.pos);
+
+	CHECK(zay::src_scan(src));
+	CHECK(zay::src_parse(src, zay::MODE::NONE));
+	//the parser counts the positions as it reads the tokens so the line table is never built
+	CHECK(src->lines.count == 0);
+	CHECK(src->ast.decls.count == 4);
+	CHECK(src->ast.decls[3]->name.pos.line == 9);
+	CHECK(src->ast.decls[3]->name.pos.col == 5);
+
+	zay::src_tkns_dump(src, mn::memory::tmp());
+	CHECK(src->lines.count == 0);
+	size_t i = 0;
+	for(size_t j = 0; j < zay::tkn_store_count(src->tkns); ++j)
+	{
+		zay::Tkn t = zay::src_tkn_at(src, j);
+		CHECK(t.pos.line == scanned[i].line);
+		CHECK(t.pos.col == scanned[i].col);
+		++i;
+	}
+	CHECK(i == scanned.count);
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: scan parse big file")
+{
+	//a long comment makes the file big enough to be scanned in chunks
+	auto code = mn::str_tmp();
+	mn::str_push(code, "func origin(): Point { return Point{x: 0, y: 0} }\ntype Point struct { x, y: int }\n//");
+	for(size_t i = 0; i < 3 * 1024 * 1024 / 16; ++i)
+		mn::str_push(code, "xxxxxxxxxxxxxxxx");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	//big files go through the parallel scan so their tokens are stored
+	CHECK((zay::tkn_store_count(src->tkns) > 0) == (zay::src_scan_chunks_count(src) > 1));
+	auto answer = zay::src_ast_dump(src, mn::memory::tmp());
+	zay::src_free(src);
+
+	CHECK(answer == parse(code.ptr));
+}
+
+TEST_CASE("[zay]: ast arena")
+{
+	auto top = mn::allocator_top();
+	auto src = zay::src_from_str(R"CODE(
+	type vec3f union {
+		data: [3]float32
+		elements: struct {
+			x, y, z: float32
+		}
+	}
+	)CODE");
+	CHECK(zay::src_scan(src));
+	CHECK(zay::src_parse(src, zay::MODE::NONE));
+	CHECK(mn::allocator_top() == top);
+
+	//the typer adds the unnamed struct decl to the ast as well
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	CHECK(mn::allocator_top() == top);
+	CHECK(src->ast.decls.count == 2);
+
+	//all of it goes away with the arena
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: parse around comment tokens")
+{
+	auto answer = parse(R"CODE(//leading
+type Point struct { //after the brace
+	//inside
+	x, y: int
+} //trailing
+//last)CODE");
+
+	const char* expected = R"CODE(type Point struct {
+	x, y: int
+})CODE";
+	CHECK(answer == parse(expected));
+}
+
+TEST_CASE("[zay]: parse many typenames")
+{
+	//complits are only recognized for known typenames, used here before and after their declarations
+	auto code = mn::str_tmp();
+	code = mn::strf(code, "func f(): T0 {{ return T299{{x: 1}} }}\n");
+	for(size_t i = 0; i < 300; ++i)
+		code = mn::strf(code, "type T{} struct {{ x: int }}\n", i);
+	code = mn::strf(code, "func g(): T150 {{ return T150{{x: 2}} }}\n");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan(src));
+	CHECK(zay::src_parse(src, zay::MODE::NONE));
+	CHECK(src->ast.decls.count == 302);
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: flat ast")
+{
+	const char* code = R"CODE(
+type Color enum { Red, Green = 2, Blue }
+type Point struct {
+	x, y: int
+	p: *[4]float32
+}
+type Shape union {
+	a: Point
+	b: struct { r: float64 }
+}
+var g, h: int = 1, 2
+func sum(xs: *int, n: int): int {
+	var res = 0
+	for var i = 0; i < n; ++i {
+		if xs[i] < 0 {
+			continue
+		} else if xs[i] > 100 {
+			break
+		} else {
+			res += xs[i]
+		}
+	}
+	return res
+}
+func main() {
+	var p = Point{x: 1, y: -2}
+	p.x, p.y = p.y, (p.x + 1) * 2
+	sum(&p.x, 2)
+	var f = p.x:float32
+}
+)CODE";
+
+	auto src = zay::src_from_str(code);
+	CHECK(zay::src_scan(src));
+	CHECK(zay::src_parse(src, zay::MODE::NONE));
+
+	auto flat = zay::flat_ast_from(src->ast);
+	CHECK(flat.decls.count == src->ast.decls.count);
+	CHECK(sizeof(zay::Flat_Node) == 16);
+
+	//the dump of the flat ast should be the same as the pointer one
+	auto out = mn::memory_stream_new(mn::memory::tmp());
+	auto writer = zay::ast_lisp_new(out);
+	for(size_t i = 0; i < flat.decls.count; ++i)
+	{
+		zay::ast_lisp_decl(writer, flat, zay::Flat_Ix(i));
+		mn::print_to(out, "\n");
+	}
+	CHECK(mn::memory_stream_str(out) == zay::src_ast_dump(src, mn::memory::tmp()));
+
+	zay::flat_ast_free(flat);
+	zay::src_free(src);
+}
+
+inline static mn::Str
+lazy_c(const char* code, bool streaming)
+{
+	auto src = zay::src_from_str(code);
+	src->bodies = zay::BODIES::LAZY;
+	if(streaming)
+	{
+		CHECK(zay::src_scan_parse(src, zay::MODE::EXE));
+	}
+	else
+	{
+		CHECK(zay::src_scan(src));
+		CHECK(zay::src_parse(src, zay::MODE::EXE));
+	}
+
+	//nothing is parsed until the typer reaches it
+	for(auto d: src->ast.decls)
+		if(d->kind == zay::Decl::KIND_FUNC)
+			CHECK(d->func_decl.body == nullptr);
+
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_EXE));
+	auto res = zay::src_c(src, mn::memory::tmp());
+
+	//the unused function is never parsed, its body isn't even valid code
+	CHECK(src->ast.decls[src->ast.decls.count - 1]->func_decl.body == nullptr);
+	zay::src_free(src);
+	return res;
+}
+
+TEST_CASE("[zay]: lazy function bodies")
+{
+	const char* code = R"CODE(package main
+type Point struct {
+	x, y: int
+}
+func add(a, b: Point): Point {
+	//braces in comments don't count }
+	return Point{x: a.x + b.x, y: a.y + b.y}
+}
+func main() {
+	var p = add(Point{x: 1, y: 2}, Point{x: 3, y: 4})
+	{ p.x = 2 }
+}
+func unused() {
+	if { var = = "}}" }
+})CODE";
+
+	auto expected = lazy_c(code, false);
+	CHECK(expected.count > 0);
+	CHECK(lazy_c(code, true) == expected);
+}
+
+inline static mn::Str
+parallel_dump(const char* code, zay::MODE mode, size_t slices_count)
+{
+	auto src = zay::src_from_str(code);
+	CHECK(zay::src_scan(src));
+	if(slices_count > 1)
+		zay::src_parse_parallel(src, mode, slices_count);
+	else
+		zay::src_parse(src, mode);
+
+	auto res = zay::src_ast_dump(src, mn::memory::tmp());
+	mn::str_push(res, zay::src_errs_dump(src, mn::memory::tmp()));
+	zay::src_free(src);
+	return res;
+}
+
+TEST_CASE("[zay]: parallel parse")
+{
+	const char* code = R"CODE(package main
+type Point struct {
+	x, y: int
+}
+func add(a, b: Point): Point {
+	var c: Point
+	c.x = a.x + b.x
+	c.y = a.y + b.y
+	return c
+}
+type Pair struct { a, b: Point }
+var g = Pair{}
+func main() {
+	var p = add(Point{x: 1, y: 2}, Point{x: 3, y: 4})
+}
+)CODE";
+
+	auto answer = parallel_dump(code, zay::MODE::EXE, 1);
+	CHECK(answer.count > 0);
+	for(size_t i = 2; i < 10; ++i)
+		CHECK(parallel_dump(code, zay::MODE::EXE, i) == answer);
+
+	//a function type isn't a declaration so the tokens are never split at it
+	const char* func_types = R"CODE(var f: func(a: int): int
+var g: func(): int
+func h() {}
+)CODE";
+	for(size_t i = 2; i < 6; ++i)
+	{
+		auto src = zay::src_from_str(func_types);
+		CHECK(zay::src_scan(src));
+		CHECK(zay::src_parse_parallel(src, zay::MODE::NONE, i));
+		CHECK(src->ast.decls.count == 3);
+		if(src->ast.decls.count == 3)
+		{
+			CHECK(::strcmp(src->ast.decls[0]->name.str, "f") == 0);
+			CHECK(::strcmp(src->ast.decls[1]->name.str, "g") == 0);
+			CHECK(::strcmp(src->ast.decls[2]->name.str, "h") == 0);
+		}
+		zay::src_free(src);
+	}
+
+	//the sequential parse reports the stray statement and stops there
+	const char* stopped = R"CODE(var a: int
+var b: int
+a = b
+var c: int
+var d: int
+)CODE";
+	answer = parallel_dump(stopped, zay::MODE::NONE, 1);
+	for(size_t i = 2; i < 6; ++i)
+		CHECK(parallel_dump(stopped, zay::MODE::NONE, i) == answer);
+
+	//the unclosed paren makes the sequential parse report errors in the declarations after it, so on
+	//errors the parallel parse falls back to it
+	const char* broken = R"CODE(var a = (1 + 2
+var b: int
+var c = 3
+var d: int
+)CODE";
+	answer = parallel_dump(broken, zay::MODE::NONE, 1);
+	CHECK(answer.count > 0);
+	for(size_t i = 2; i < 6; ++i)
+		CHECK(parallel_dump(broken, zay::MODE::NONE, i) == answer);
+}
+
+TEST_CASE("[zay]: ast cache")
+{
+	const char* code = R"CODE(package main
+type Color enum { Red, Green = 4 }
+type Point struct {
+	x, y: int
+}
+var origin = Point{x: 0, y: 0}
+func add(a, b: Point): Point {
+	var c: Point
+	c.x = a.x + b.x * 2
+	c.y = -a.y + b.y
+	return c
+}
+func main() {
+	var p = add(origin, Point{x: 3, y: 4})
+	for var i = 0; i < 10; i += 1 {
+		if i == 2 {
+			continue
+		} else if i > 8 {
+			break
+		}
+	}
+}
+func unused() {
+	if { var = = "}}" }
+})CODE";
+
+	auto src = zay::src_from_str(code);
+	src->bodies = zay::BODIES::LAZY;
+	CHECK(zay::src_scan_parse(src, zay::MODE::EXE));
+	auto blob = zay::ast_cache_encode(src, zay::MODE::EXE, mn::memory::tmp());
+	auto answer = zay::src_ast_dump(src, mn::memory::tmp());
+
+	//the cached AST is the same, even the lazy bodies stay lazy
+	auto cached = zay::src_from_str(code);
+	cached->bodies = zay::BODIES::LAZY;
+	CHECK(zay::ast_cache_decode(cached, zay::MODE::EXE, mn::block_from(blob)));
+	CHECK(zay::tkn_store_count(cached->tkns) == 0);
+	CHECK(cached->tkns.values.count == src->tkns.values.count);
+	CHECK(zay::src_ast_dump(cached, mn::memory::tmp()) == answer);
+	CHECK(cached->ast.decls[cached->ast.decls.count - 1]->func_decl.body == nullptr);
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_EXE));
+	CHECK(zay::src_typecheck(cached, zay::Typer::MODE_EXE));
+	CHECK(zay::src_c(cached, mn::memory::tmp()) == zay::src_c(src, mn::memory::tmp()));
+	zay::src_free(cached);
+	zay::src_free(src);
+
+	//another mode, another content or a broken blob are all misses which leave the AST empty
+	auto other = zay::src_from_str(code);
+	other->bodies = zay::BODIES::LAZY;
+	CHECK(zay::ast_cache_decode(other, zay::MODE::LIB, mn::block_from(blob)) == false);
+	auto truncated = mn::block_from(blob);
+	truncated.size -= 1;
+	CHECK(zay::ast_cache_decode(other, zay::MODE::EXE, truncated) == false);
+	CHECK(other->ast.decls.count == 0);
+	zay::src_free(other);
+
+	other = zay::src_from_str("package main\nfunc main() {}");
+	CHECK(zay::ast_cache_decode(other, zay::MODE::EXE, mn::block_from(blob)) == false);
+	zay::src_free(other);
+
+	//the lazy bodies aren't in the blob so an eager src misses it
+	other = zay::src_from_str(code);
+	CHECK(zay::ast_cache_decode(other, zay::MODE::EXE, mn::block_from(blob)) == false);
+	auto eager_path = zay::ast_cache_path(other, zay::MODE::EXE, "cache", mn::memory::tmp());
+	other->bodies = zay::BODIES::LAZY;
+	CHECK((zay::ast_cache_path(other, zay::MODE::EXE, "cache", mn::memory::tmp()) == eager_path) == false);
+	zay::src_free(other);
+}
+
+TEST_CASE("[zay]: ast cache deep exprs")
+{
+	//the cache walks the exprs like the rest of the compiler so a deep chain doesn't blow the stack
+	constexpr size_t TERMS = 200000;
+	auto code = mn::str_new();
+	mn::str_push(code, "var x = 1");
+	for(size_t i = 1; i < TERMS; ++i)
+		mn::str_push(code, " + 1");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	auto blob = zay::ast_cache_encode(src, zay::MODE::NONE, mn::memory::tmp());
+
+	auto cached = zay::src_from_str(code.ptr);
+	CHECK(zay::ast_cache_decode(cached, zay::MODE::NONE, mn::block_from(blob)));
+	CHECK(zay::src_ast_dump(cached, mn::memory::tmp()) == zay::src_ast_dump(src, mn::memory::tmp()));
+
+	zay::src_free(cached);
+	zay::src_free(src);
+	mn::str_free(code);
+}
+
+TEST_CASE("[zay]: deeply nested exprs")
+{
+	//a left leaning chain as deep as the number of terms, walking it recursively would blow the stack
+	constexpr size_t TERMS = 200000;
+	auto code = mn::str_new();
+	mn::str_push(code, "var x = 1");
+	for(size_t i = 1; i < TERMS; ++i)
+		mn::str_push(code, " + 1");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(src->ast.decls.count == 1);
+
+	auto dump = zay::src_ast_dump(src, mn::memory::tmp());
+	CHECK(dump.count > TERMS * 10);
+
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	auto c = zay::src_c(src);
+	CHECK(c.count > TERMS * 3);
+	mn::str_free(c);
+
+	zay::src_free(src);
+	mn::str_free(code);
+}
+
+TEST_CASE("[zay]: deeply nested ifs")
+{
+	//every if opens a block inside the one before it, parsing or walking them recursively would blow the stack
+	constexpr size_t DEPTH = 100000;
+	auto code = mn::str_new();
+	mn::str_push(code, "func f() {\n");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, "if true {\n");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, "}\n");
+	mn::str_push(code, "}");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(src->ast.decls.count == 1);
+
+	size_t depth = 0;
+	zay::Stmt* block = src->ast.decls[0]->func_decl.body;
+	while(block->block_stmt.count == 1 && block->block_stmt[0]->kind == zay::Stmt::KIND_IF)
+	{
+		block = block->block_stmt[0]->if_stmt.if_body;
+		++depth;
+	}
+	CHECK(depth == DEPTH);
+	CHECK(block->block_stmt.count == 0);
+
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	zay::src_free(src);
+	mn::str_free(code);
+}
+
+TEST_CASE("[zay]: deeply nested parens")
+{
+	//open parens and unary operators wait for their operand on the parser's stack instead of the call stack
+	constexpr size_t DEPTH = 100000;
+	auto code = mn::str_new();
+	mn::str_push(code, "var x = ");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, "(");
+	mn::str_push(code, "1");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, ")");
+	mn::str_push(code, "\nvar y = ");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, "-(");
+	mn::str_push(code, "1");
+	for(size_t i = 0; i < DEPTH; ++i)
+		mn::str_push(code, ")");
+
+	auto src = zay::src_from_str(code.ptr);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(src->ast.decls.count == 2);
+
+	size_t depth = 0;
+	zay::Expr* expr = src->ast.decls[0]->var_decl.exprs[0];
+	while(expr->kind == zay::Expr::KIND_PAREN)
+	{
+		expr = expr->paren;
+		++depth;
+	}
+	CHECK(depth == DEPTH);
+	CHECK(expr->kind == zay::Expr::KIND_ATOM);
+
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	auto c = zay::src_c(src);
+	CHECK(c.count > DEPTH * 5);
+	mn::str_free(c);
+
+	zay::src_free(src);
+	mn::str_free(code);
+}
+
 bool
 typecheck(const char* str)
 {
@@ -524,19 +1378,19 @@ TEST_CASE("[zay]: pointers")
 {
 	CHECK(typecheck(R"CODE(
 		func foo(x: int): *int { return &x }
-		var x: *int = foo(143);
+		var x: *int = foo(143)
 		var y: int = *x
 	)CODE") == true);
 
 	CHECK(typecheck(R"CODE(
 		func foo(x: int): *int { return &x }
-		var x: *float32 = foo(143);
+		var x: *float32 = foo(143)
 		var y: float32 = *x
 	)CODE") == false);
 
 	CHECK(typecheck(R"CODE(
 		func foo(x: int): *int { return &x }
-		var x: *float32 = foo(143): *float32;
+		var x: *float32 = foo(143): *float32
 		var y: float32 = *x
 	)CODE") == true);
 }
@@ -864,6 +1718,141 @@ TEST_CASE("[zay]: missing return")
 	)CODE") == false);
 }
 
+TEST_CASE("[zay]: scope lookup by interned name")
+{
+	auto pool = zay::intern_pool_global();
+	const char* x = zay::intern_pool_get(pool, "x");
+	CHECK(zay::intern_hash_of(x) == zay::intern_hash(x, x + 1));
+
+	//enough syms to make the tables grow a few times
+	auto global = zay::scope_new(nullptr, false, nullptr);
+	auto local = zay::scope_new(global, false, nullptr);
+	char name[32];
+	for(size_t i = 0; i < 100; ++i)
+	{
+		::snprintf(name, sizeof(name), "sym_%zu", i);
+		auto id = zay::tkn_anonymous_id(zay::intern_pool_get(pool, name));
+		zay::scope_add(i % 2 ? local : global, zay::sym_var(id, nullptr, zay::Type_Sign{}, nullptr));
+	}
+
+	for(size_t i = 0; i < 100; ++i)
+	{
+		::snprintf(name, sizeof(name), "sym_%zu", i);
+		const char* interned = zay::intern_pool_get(pool, name);
+		auto sym = zay::scope_find(local, interned);
+		CHECK(sym != nullptr);
+		CHECK(sym->name == interned);
+		CHECK((zay::scope_has(global, interned) != nullptr) == (i % 2 == 0));
+	}
+	CHECK(zay::scope_find(local, x) == nullptr);
+
+	zay::scope_free(local);
+	zay::scope_free(global);
+}
+
+TEST_CASE("[zay]: interned type signs")
+{
+	const char* code = R"CODE(
+type Point struct {
+	x, y: int
+}
+var a: *Point
+var b: *Point
+var c: [4]float32
+var f: func(p: *Point): int
+var g: func(q: *Point): int
+var s: struct { x: int }
+var t: struct { x: int }
+func h(p: *Point): [4]float32 {
+	var d: *Point = p
+	return c
+})CODE";
+
+	auto src = zay::src_from_str(code);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	auto& decls = src->ast.decls;
+	CHECK(decls.count == 9);
+
+	//the same sign is the same node wherever it's written
+	zay::Type_Sign ptr = decls[1]->var_decl.type;
+	CHECK(ptr->interned);
+	CHECK(decls[2]->var_decl.type == ptr);
+	CHECK(decls[8]->func_decl.args[0].type == ptr);
+	CHECK(decls[8]->func_decl.ret_type == decls[3]->var_decl.type);
+	CHECK(decls[4]->var_decl.type == decls[5]->var_decl.type);
+	CHECK(decls[4]->var_decl.type != ptr);
+
+	//every struct sign declares its own type so it's never shared
+	CHECK(decls[6]->var_decl.type->interned == false);
+	CHECK(decls[6]->var_decl.type != decls[7]->var_decl.type);
+
+	//the resolved type is cached on the shared node
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	CHECK(ptr->type != nullptr);
+	CHECK(ptr->type->kind == zay::Type::KIND_PTR);
+	zay::src_free(src);
+
+	//both uses share the sign of the first one but each of them reports its own error, the parser only
+	//takes declared typenames so the declaration is dropped to leave the typer an undefined one
+	src = zay::src_from_str(R"CODE(type Bar int
+var u: *Bar
+func z() {
+	var v: *Bar
+})CODE");
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	mn::buf_remove_ordered(src->ast.decls, 0);
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE) == false);
+	CHECK(src->errs.count == 2);
+	CHECK(src->errs[0].pos.line == 2);
+	CHECK(src->errs[1].pos.line == 4);
+	zay::src_free(src);
+}
+
+TEST_CASE("[zay]: interned type signs shadowed")
+{
+	const char* code = R"CODE(
+type Foo struct {
+	x: int
+}
+var g: Foo
+func f(): int {
+	var Foo: int = 2
+	var a: Foo = 3
+	return a + Foo
+}
+func k(): int {
+	var b: Foo
+	return b.x
+})CODE";
+
+	//the local Foo shadows the global type in f but not in k though both use the same sign
+	auto src = zay::src_from_str(code);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	CHECK(src->ast.decls[1]->var_decl.type->type->kind == zay::Type::KIND_STRUCT);
+	zay::src_free(src);
+
+	//the same goes for the names in the args and return types of a func sign
+	const char* func_code = R"CODE(
+type Foo struct {
+	x: int
+}
+var g: func(p: Foo): int
+func n(p: int): int {
+	return p
+}
+func f(): int {
+	var Foo: int = 2
+	var h: func(p: Foo): int = n
+	return h(Foo)
+})CODE";
+
+	src = zay::src_from_str(func_code);
+	CHECK(zay::src_scan_parse(src, zay::MODE::NONE));
+	CHECK(zay::src_typecheck(src, zay::Typer::MODE_NONE));
+	zay::src_free(src);
+}
+
 inline static mn::Str
 cgen(const char* str)
 {
@@ -1193,4 +2182,38 @@ TEST_CASE("[zay]: function prototypes")
 	)CODE");
 	const char* expected = R"CODE(int32_t puts(ZayString str);)CODE";
 	CHECK(answer == expected);
+}
+
+TEST_CASE("[zay]: small buf")
+{
+	auto nums = zay::small_buf_new<zay::Small_Buf<int, 2>>();
+	zay::small_buf_push(nums, 1);
+	zay::small_buf_push(nums, 2);
+	CHECK(nums.heap == nullptr);
+	//pushing an item of the buf itself while it spills to the heap
+	zay::small_buf_push(nums, nums[0]);
+	zay::small_buf_pushn(nums, 3, 4);
+	CHECK(nums.heap != nullptr);
+	CHECK(nums.count == 6);
+
+	auto copy = zay::clone(nums);
+	zay::small_buf_free(nums);
+	int sum = 0;
+	for(int n: copy)
+		sum += n;
+	CHECK(sum == 16);
+	zay::small_buf_free(copy);
+
+	//short lists stay inline, long ones spill, and both read the same
+	CHECK(parse_expr("f(a)") == "(call (atom f) (atom a))");
+	CHECK(parse_expr("f(a, b, c, d, e)") == "(call (atom f) (atom a), (atom b), (atom c), (atom d), (atom e))");
+	auto answer = cgen(R"CODE(
+		func sum(a, b, c, d, e: int): int {
+			return a + b + c + d + e
+		}
+	)CODE");
+	const char* expected = R"CODE(ZayInt sum(ZayInt a, ZayInt b, ZayInt c, ZayInt d, ZayInt e) {
+	return a + b + c + d + e;
+})CODE";
+	CHECK(answer == expected);
 }
\ No newline at end of file
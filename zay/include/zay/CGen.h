@@ -17,6 +17,10 @@ namespace zay
 		Src *src;
 		mn::Memory_Stream out;
 		mn::Buf<Scope*> scope_stack;
+		// frames of the expr walks, it's kept around so writing exprs doesn't allocate
+		mn::Buf<Expr_Walk_Frame> expr_stack;
+		// frames of the stmt walks, deeply nested stmts don't grow the call stack
+		mn::Buf<Stmt_Walk_Frame> stmt_stack;
 	};
 
 	ZAY_EXPORT CGen
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "zay/Exports.h"
+
+#include <mn/Str.h>
+
+namespace zay
+{
+	// maps the given file into memory as a read only view, the returned string is not null terminated
+	// and doesn't own its memory, it returns an empty string if the file can't be mapped or is empty
+	ZAY_EXPORT mn::Str
+	file_map(const char* path);
+
+	// unmaps a view returned by file_map
+	ZAY_EXPORT void
+	file_unmap(mn::Str& view);
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "zay/Exports.h"
+
+#include <mn/Str.h>
+#include <mn/Buf.h>
+#include <mn/Thread.h>
+
+#include <stdint.h>
+#include <string.h>
+
+namespace zay
+{
+	// must be a power of 2
+	constexpr size_t INTERN_SHARDS_COUNT = 64;
+
+	struct Intern_Entry
+	{
+		uint64_t hash;
+		const char* str;
+		size_t len;
+	};
+
+	// a slice of the pool, the string's hash picks the shard so threads interning different strings
+	// rarely wait on the same lock
+	struct Intern_Shard
+	{
+		mn::Mutex mtx;
+		// open addressing table with linear probing, its count is always a power of 2
+		mn::Buf<Intern_Entry> table;
+		size_t count;
+		// pages of the bump allocator which holds the strings
+		mn::Buf<mn::Block> pages;
+		char* page_it;
+		char* page_end;
+	};
+
+	// Intern_Pool is a thread safe string intern table which many compilation units share, interned
+	// strings are null terminated, preceded by their hash, and stay at the same address until the pool
+	// is freed so equal strings can be compared by pointer across compilation units
+	struct Intern_Pool
+	{
+		Intern_Shard shards[INTERN_SHARDS_COUNT];
+	};
+
+	ZAY_EXPORT Intern_Pool*
+	intern_pool_new();
+
+	ZAY_EXPORT void
+	intern_pool_free(Intern_Pool* self);
+
+	inline static void
+	destruct(Intern_Pool* self)
+	{
+		intern_pool_free(self);
+	}
+
+	// the process wide pool which all the Srcs use
+	ZAY_EXPORT Intern_Pool*
+	intern_pool_global();
+
+	// hash of the string in [begin, end), it's the one the pool stores with the interned strings
+	ZAY_EXPORT uint64_t
+	intern_hash(const char* begin, const char* end);
+
+	// interns the string in [begin, end)
+	ZAY_EXPORT const char*
+	intern_pool_get(Intern_Pool* self, const char* begin, const char* end);
+
+	// returns the hash of a string returned by intern_pool_get without touching the pool, so the interned
+	// pointer works as an id which carries its own hash, str must come from an Intern_Pool
+	inline static uint64_t
+	intern_hash_of(const char* str)
+	{
+		uint64_t res = 0;
+		::memcpy(&res, str - sizeof(uint64_t), sizeof(res));
+		return res;
+	}
+
+	inline static const char*
+	intern_pool_get(Intern_Pool* self, const char* str)
+	{
+		return intern_pool_get(self, str, str + ::strlen(str));
+	}
+
+	inline static const char*
+	intern_pool_get(Intern_Pool* self, const mn::Str& str)
+	{
+		return intern_pool_get(self, str.ptr, str.ptr + str.count);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <mn/Memory.h>
+
+#include <assert.h>
+#include <string.h>
+#include <stddef.h>
+
+namespace zay
+{
+	// Small_Buf is a buf which keeps its first N items inline so the short lists in the AST (ids, call args
+	// and the like) don't allocate, it only moves to the heap once it grows past N, it copies shallowly like
+	// mn::Buf so only one of the copies should be freed, and it only holds trivially copyable items
+	template<typename T, size_t N>
+	struct Small_Buf
+	{
+		// the items once they don't fit inline, it's null until then
+		T* heap;
+		size_t count;
+		// capacity of heap, it's 0 while the items are inline
+		size_t cap;
+		mn::Allocator allocator;
+		T inline_items[N];
+
+		T&
+		operator[](size_t ix)
+		{
+			assert(ix < count);
+			return heap ? heap[ix] : inline_items[ix];
+		}
+
+		const T&
+		operator[](size_t ix) const
+		{
+			assert(ix < count);
+			return heap ? heap[ix] : inline_items[ix];
+		}
+	};
+
+	template<typename T, size_t N>
+	inline static T*
+	small_buf_data(Small_Buf<T, N>& self)
+	{
+		return self.heap ? self.heap : self.inline_items;
+	}
+
+	template<typename T, size_t N>
+	inline static const T*
+	small_buf_data(const Small_Buf<T, N>& self)
+	{
+		return self.heap ? self.heap : self.inline_items;
+	}
+
+	template<typename T, size_t N>
+	inline static T*
+	begin(Small_Buf<T, N>& self)
+	{
+		return small_buf_data(self);
+	}
+
+	template<typename T, size_t N>
+	inline static const T*
+	begin(const Small_Buf<T, N>& self)
+	{
+		return small_buf_data(self);
+	}
+
+	template<typename T, size_t N>
+	inline static T*
+	end(Small_Buf<T, N>& self)
+	{
+		return small_buf_data(self) + self.count;
+	}
+
+	template<typename T, size_t N>
+	inline static const T*
+	end(const Small_Buf<T, N>& self)
+	{
+		return small_buf_data(self) + self.count;
+	}
+
+	// creates an empty small buf, the heap memory, if it's ever needed, comes from the given allocator
+	template<typename B>
+	inline static B
+	small_buf_new(mn::Allocator allocator = mn::allocator_top())
+	{
+		B self{};
+		self.allocator = allocator;
+		return self;
+	}
+
+	template<typename T, size_t N>
+	inline static void
+	small_buf_free(Small_Buf<T, N>& self)
+	{
+		if(self.heap)
+			mn::free_from(self.allocator, mn::Block{self.heap, self.cap * sizeof(T)});
+		self.heap = nullptr;
+		self.count = 0;
+		self.cap = 0;
+	}
+
+	template<typename T, size_t N>
+	inline static void
+	destruct(Small_Buf<T, N>& self)
+	{
+		for(T& item: self)
+			destruct(item);
+		small_buf_free(self);
+	}
+
+	template<typename T, size_t N>
+	inline static void
+	small_buf_reserve(Small_Buf<T, N>& self, size_t added_count)
+	{
+		size_t new_count = self.count + added_count;
+		if(new_count <= N || new_count <= self.cap)
+			return;
+
+		if(self.allocator == nullptr)
+			self.allocator = mn::allocator_top();
+
+		size_t new_cap = self.cap ? self.cap * 2 : N * 2;
+		if(new_cap < new_count)
+			new_cap = new_count;
+
+		auto block = mn::alloc_from(self.allocator, new_cap * sizeof(T), alignof(T));
+		::memcpy(block.ptr, small_buf_data(self), self.count * sizeof(T));
+		if(self.heap)
+			mn::free_from(self.allocator, mn::Block{self.heap, self.cap * sizeof(T)});
+		self.heap = (T*)block.ptr;
+		self.cap = new_cap;
+	}
+
+	template<typename T, size_t N>
+	inline static void
+	small_buf_push(Small_Buf<T, N>& self, const T& value)
+	{
+		//value might live in the buf itself so take a copy before it moves
+		T item = value;
+		small_buf_reserve(self, 1);
+		small_buf_data(self)[self.count++] = item;
+	}
+
+	template<typename T, size_t N>
+	inline static void
+	small_buf_pushn(Small_Buf<T, N>& self, size_t n, const T& value)
+	{
+		T item = value;
+		small_buf_reserve(self, n);
+		T* ptr = small_buf_data(self);
+		for(size_t i = 0; i < n; ++i)
+			ptr[self.count++] = item;
+	}
+
+	template<typename T, size_t N>
+	inline static Small_Buf<T, N>
+	clone(const Small_Buf<T, N>& other, mn::Allocator allocator = mn::allocator_top())
+	{
+		auto self = small_buf_new<Small_Buf<T, N>>(allocator);
+		small_buf_reserve(self, other.count);
+		::memcpy(small_buf_data(self), small_buf_data(other), other.count * sizeof(T));
+		self.count = other.count;
+		return self;
+	}
+
+	template<typename T, size_t N>
+	inline static mn::Block
+	block_from(const Small_Buf<T, N>& self)
+	{
+		return mn::Block{(void*)small_buf_data(self), self.count * sizeof(T)};
+	}
+}
\ No newline at end of file
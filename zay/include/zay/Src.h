@@ -3,13 +3,14 @@
 #include "zay/Exports.h"
 #include "zay/scan/Rng.h"
 #include "zay/Err.h"
+#include "zay/Intern.h"
 #include "zay/scan/Tkn.h"
+#include "zay/scan/Tkn_Store.h"
 #include "zay/parse/AST.h"
 #include "zay/typecheck/Scope.h"
 #include "zay/typecheck/Type_Intern.h"
 
 #include <mn/Str.h>
-#include <mn/Str_Intern.h>
 #include <mn/Buf.h>
 #include <mn/Map.h>
 
@@ -25,21 +26,57 @@ namespace zay
 	// Line is a range of source code
 	typedef Rng Line;
 
+	// who owns the memory of the source code content
+	enum class CONTENT
+	{
+		// allocated and freed by the Src
+		OWNED,
+		// a caller owned buffer which must outlive the Src
+		BORROWED,
+		// a read only memory mapped view of the file
+		MAPPED
+	};
+
+	// where the scanner puts the comments
+	enum class COMMENTS
+	{
+		// comments are tokens like everything else
+		TOKENS,
+		// comments are kept out of the tokens, only their ranges are recorded in Tkn_Store::trivia
+		TRIVIA
+	};
+
+	// when the parser parses the function bodies
+	enum class BODIES
+	{
+		// all of them while parsing the src
+		EAGER,
+		// the parser only matches their braces, each body is parsed the first time the typer reaches it
+		// so the bodies of unreachable functions are never parsed
+		LAZY
+	};
+
 	// Src is our compilation unit
 	struct Src
 	{
 		// path of compilation unit on disk "<STRING>" if there's none
 		mn::Str path;
-		// content of the compilation unit (the code)
+		// content of the compilation unit (the code), it's not null terminated
 		mn::Str content;
-		// source code lines
+		CONTENT content_kind;
+		// source code lines, it's empty until someone asks for it using src_lines
 		mn::Buf<Line> lines;
-		// string table for fast string compare
-		mn::Str_Intern str_table;
+		// string table for fast string compare, it's the global pool so strings of different
+		// compilation units can be compared by pointer too
+		Intern_Pool* str_table;
 		// list of errors in the compilation unit
 		mn::Buf<Err> errs;
-		// tokens of this compilation unit
-		mn::Buf<Tkn> tkns;
+		// tokens of this compilation unit, use src_tkn_at to get a token
+		Tkn_Store tkns;
+		// how comments are scanned, set it before scanning
+		COMMENTS comments;
+		// how function bodies are parsed, set it before parsing
+		BODIES bodies;
 		// AST of this compilation unit
 		AST ast;
 		// All the scopes created for this translation unit
@@ -58,26 +95,37 @@ namespace zay
 	ZAY_EXPORT Src*
 	src_from_str(const char* code);
 
+	// creates a Src which reads directly from the given code without copying it
+	// the code must outlive the returned Src
+	ZAY_EXPORT Src*
+	src_from_buffer(const char* code, size_t size);
+
 	ZAY_EXPORT void
 	src_free(Src *self);
 
+	// replaces the content [begin_offset, end_offset) with the given text, it resets the line table
+	// and doesn't touch anything else, use src_edit to also rescan the tokens
+	ZAY_EXPORT void
+	src_content_replace(Src *self, size_t begin_offset, size_t end_offset, const char* text, size_t text_count);
+
 	inline static void
 	destruct(Src *self)
 	{
 		src_free(self);
 	}
 
-	inline static void
-	src_line_begin(Src *self, const char* begin)
-	{
-		mn::buf_push(self->lines, Line{begin, begin});
-	}
+	// returns the lines of the source code, the line table is built on the first call
+	ZAY_EXPORT const mn::Buf<Line>&
+	src_lines(Src *self);
 
-	inline static void
-	src_line_end(Src *self, const char* end)
-	{
-		mn::buf_top(self->lines).end = end;
-	}
+	// returns the position of the given pointer into the source code content
+	ZAY_EXPORT Pos
+	src_pos(Src *self, const char* it);
+
+	// returns the position of it given the position of an earlier pointer into the same code, it only
+	// reads the code between them so reading the code in order never needs the line table
+	ZAY_EXPORT Pos
+	pos_advance(Pos pos, const char* from, const char* it);
 
 	inline static void
 	src_err(Src *self, const Err& e)
@@ -94,9 +142,25 @@ namespace zay
 	inline static void
 	src_tkn(Src *self, const Tkn& t)
 	{
-		mn::buf_push(self->tkns, t);
+		tkn_store_push(self->tkns, begin(self->content), t);
+	}
+
+	// returns the token at the given index of the token store
+	ZAY_EXPORT Tkn
+	src_tkn_at(Src *self, size_t ix);
+
+	// returns the decoded value of the literal token, it's zero if the token isn't a literal
+	inline static Tkn_Value
+	src_tkn_value(Src *self, const Tkn& tkn)
+	{
+		return tkn_store_value(self->tkns, size_t(tkn.rng.begin - begin(self->content)));
 	}
 
+	// returns the token at the given index of the token store with the given position, the store doesn't
+	// keep the positions so use it when you already know where the token is
+	ZAY_EXPORT Tkn
+	src_tkn_at(Src *self, size_t ix, Pos pos);
+
 	inline static Scope*
 	src_scope_new(Src *self, void* ast_node, Scope* parent, bool inside_loop, Type* ret)
 	{
@@ -4,13 +4,29 @@
 #include "zay/parse/Decl.h"
 
 #include <mn/Buf.h>
+#include <mn/Memory.h>
 
 namespace zay
 {
+	constexpr size_t AST_ARENA_BLOCK_SIZE = 64 * 1024;
+
 	struct AST
 	{
 		Tkn package;
 		mn::Buf<Decl*> decls;
+		//all the nodes and their child arrays are allocated from this arena while parsing so freeing
+		//the AST is a single release and sibling nodes end up next to each other in memory
+		mn::Allocator arena;
+		//a parallel parse gives every thread its own arena, the decls parsed on them live in these
+		mn::Buf<mn::Allocator> slice_arenas;
+		//the tokens following the type keyword in declaration order, the parser collects them upfront
+		//because typenames can be used before their declaration, they carry the declaration positions
+		mn::Buf<Tkn> typenames;
+		//open addressing set of the interned typenames, empty until the first typename is added then
+		//its count is always a power of 2
+		mn::Buf<const char*> typenames_set;
+		//the type signs without struct, union or enum atoms are interned here so their uses share them
+		Type_Sign_Table signs;
 	};
 
 	ZAY_EXPORT AST
@@ -24,4 +40,12 @@ namespace zay
 	{
 		ast_free(self);
 	}
+
+	// adds the token to the typenames if it's an id
+	ZAY_EXPORT void
+	ast_typename_add(AST &self, const Tkn& tkn);
+
+	// whether the interned name is one of the typenames
+	ZAY_EXPORT bool
+	ast_typename_has(const AST &self, const char* name);
 }
\ No newline at end of file
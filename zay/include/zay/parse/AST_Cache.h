@@ -0,0 +1,38 @@
+#pragma once
+
+#include "zay/Exports.h"
+#include "zay/Src.h"
+
+#include <mn/Buf.h>
+#include <mn/Str.h>
+#include <mn/Memory.h>
+
+#include <stdint.h>
+
+namespace zay
+{
+	// the cache is keyed by this version instead of the compiler version so compiler changes which don't touch
+	// the parser keep their cache, bump it whenever the AST, the parser output or the blob layout changes so
+	// the old cache files are ignored
+	constexpr uint32_t AST_CACHE_VERSION = 3;
+
+	// encodes the src's AST into a relocatable binary blob, it has no pointers, the interned strings are stored
+	// once in an embedded string table and the source ranges are offsets into Src::content
+	ZAY_EXPORT mn::Buf<uint8_t>
+	ast_cache_encode(Src *src, MODE mode, mn::Allocator allocator = mn::allocator_top());
+
+	// decodes a blob made by ast_cache_encode into the src's AST, it returns false and leaves the AST empty
+	// if the blob is corrupted or was made for another content, mode, bodies or cache version
+	ZAY_EXPORT bool
+	ast_cache_decode(Src *src, MODE mode, const mn::Block& data);
+
+	// path of the src's cache file in the given folder, its name is the hash of the content, the mode, the
+	// bodies and AST_CACHE_VERSION, lazy bodies are left unparsed so they make a different AST
+	ZAY_EXPORT mn::Str
+	ast_cache_path(Src *src, MODE mode, const char* folder, mn::Allocator allocator = mn::allocator_top());
+
+	// works like src_scan_parse but loads the AST from the cache folder if it's there which skips scanning
+	// and parsing, on a miss the src is scanned and parsed then its AST is cached if it has no errors
+	ZAY_EXPORT bool
+	src_scan_parse_cached(Src *src, MODE mode, const char* folder);
+}
\ No newline at end of file
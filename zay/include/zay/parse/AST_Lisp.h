@@ -2,6 +2,7 @@
 
 #include "zay/Exports.h"
 #include "zay/parse/AST.h"
+#include "zay/parse/Flat_AST.h"
 
 #include <mn/Stream.h>
 
@@ -29,4 +30,14 @@ namespace zay
 
 	ZAY_EXPORT void
 	ast_lisp_decl(AST_Lisp& self, Decl* decl);
+
+	// the flat ast dumps are the same as the pointer ast ones
+	ZAY_EXPORT void
+	ast_lisp_expr(AST_Lisp& self, const Flat_AST& ast, Flat_Ix expr);
+
+	ZAY_EXPORT void
+	ast_lisp_stmt(AST_Lisp& self, const Flat_AST& ast, Flat_Ix stmt);
+
+	ZAY_EXPORT void
+	ast_lisp_decl(AST_Lisp& self, const Flat_AST& ast, Flat_Ix decl);
 }
\ No newline at end of file
@@ -13,7 +13,7 @@ namespace zay
 	//Function Arguments
 	struct Arg
 	{
-		mn::Buf<Tkn> ids;
+		Id_List ids;
 		Type_Sign type;
 	};
 
@@ -21,15 +21,15 @@ namespace zay
 	arg_new()
 	{
 		return Arg{
-			mn::buf_new<Tkn>(),
-			type_sign_new()
+			small_buf_new<Id_List>(),
+			nullptr
 		};
 	}
 
 	inline static void
 	arg_free(Arg& self)
 	{
-		mn::buf_free(self.ids);
+		small_buf_free(self.ids);
 		type_sign_free(self.type);
 	}
 
@@ -63,6 +63,9 @@ namespace zay
 				mn::Buf<Arg> args;
 				Type_Sign ret_type;
 				Stmt* body;
+				// the { token of a body which isn't parsed yet, see BODIES::LAZY
+				// body is null until src_parse_func_body parses it
+				Tkn lazy_body_open;
 			} func_decl;
 
 			Type_Sign type_decl;
@@ -86,4 +89,4 @@ namespace zay
 	{
 		decl_free(self);
 	}
-}
+}
\ No newline at end of file
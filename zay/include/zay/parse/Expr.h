@@ -15,6 +15,9 @@ namespace zay
 	//Expressions
 	struct Expr;
 
+	// most calls pass up to three args so they're stored inline
+	typedef Small_Buf<Expr*, 3> Call_Args;
+
 	struct Complit_Field {
 		enum KIND
 		{
@@ -80,7 +83,7 @@ namespace zay
 			struct
 			{
 				Expr* base;
-				mn::Buf<Expr*> args;
+				Call_Args args;
 			} call;
 
 			struct
@@ -106,7 +109,7 @@ namespace zay
 	expr_paren(Expr* e);
 
 	ZAY_EXPORT Expr*
-	expr_call(Expr* base, const mn::Buf<Expr*>& args);
+	expr_call(Expr* base, const Call_Args& args);
 
 	ZAY_EXPORT Expr*
 	expr_indexed(Expr* base, Expr* index);
@@ -134,4 +137,38 @@ namespace zay
 	{
 		expr_free(self);
 	}
+
+	// Expr_Walk_Frame is an expr which is being walked and the number of times it was visited
+	struct Expr_Walk_Frame
+	{
+		Expr* expr;
+		size_t step;
+	};
+
+	// returns the child at the given index in evaluation order or nullptr if there's none, the children
+	// of a complit are the left then the right expr of each field
+	ZAY_EXPORT Expr*
+	expr_child(Expr* self, size_t ix);
+
+	// walks the expr tree without recursion so the depth of the tree doesn't grow the call stack, visit is
+	// called with step 0 when the walk enters an expr then with step i after the walk is done with the i-th
+	// child it returned, it returns the next child to walk or nullptr once the expr is done, the frames are
+	// pushed after stack.count and popped before returning so walks started from visit share the stack
+	template<typename T>
+	inline static void
+	expr_walk(mn::Buf<Expr_Walk_Frame>& stack, Expr* root, T& ctx, Expr* (*visit)(T&, Expr*, size_t))
+	{
+		size_t base = stack.count;
+		mn::buf_push(stack, Expr_Walk_Frame{root, 0});
+		while(stack.count > base)
+		{
+			//visit may walk other exprs which can move the stack so don't hold on to the frame
+			Expr_Walk_Frame frame = stack[stack.count - 1];
+			stack[stack.count - 1].step++;
+			if(Expr* child = visit(ctx, frame.expr, frame.step))
+				mn::buf_push(stack, Expr_Walk_Frame{child, 0});
+			else
+				mn::buf_pop(stack);
+		}
+	}
 }
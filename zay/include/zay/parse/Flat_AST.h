@@ -0,0 +1,104 @@
+#pragma once
+
+#include "zay/Exports.h"
+#include "zay/scan/Tkn.h"
+#include "zay/parse/AST.h"
+
+#include <mn/Buf.h>
+
+#include <stdint.h>
+
+namespace zay
+{
+	// index of a node in one of the Flat_AST node arrays, or of a record in Flat_AST::extra
+	typedef uint32_t Flat_Ix;
+
+	// the missing node, like a null Expr* in the pointer AST
+	constexpr Flat_Ix FLAT_NIL = UINT32_MAX;
+
+	// Flat_Node is a 16 bytes node, kind is the Expr, Stmt, Decl or Type_Atom kind depending on the array
+	// it lives in, tkn is an index in Flat_AST::tkns and lhs, rhs are node indices or extra records
+	struct Flat_Node
+	{
+		uint8_t kind;
+		uint32_t tkn;
+		Flat_Ix lhs;
+		Flat_Ix rhs;
+	};
+
+	// Flat_AST is an index based AST, the nodes of each kind are stored contiguously and children are
+	// referenced by 32-bit indices, variable length children live in extra as records, a list record is
+	// the count followed by the items
+	//
+	// exprs:
+	//  ATOM: tkn
+	//  BINARY: tkn op, lhs expr, rhs expr
+	//  UNARY: tkn op, lhs expr
+	//  DOT: tkn member, lhs base expr
+	//  INDEXED: lhs base expr, rhs index expr
+	//  CALL: lhs base expr, rhs list of exprs
+	//  CAST: lhs base expr, rhs type sign
+	//  PAREN: lhs expr
+	//  COMPLIT: lhs type sign, rhs list of (field kind, left expr, right expr) triplets
+	// stmts:
+	//  BREAK, CONTINUE: tkn
+	//  RETURN, EXPR: lhs expr
+	//  IF: lhs cond expr, rhs [body stmt, else body stmt, count, (cond expr, body stmt)...]
+	//  FOR: lhs [init stmt, cond expr, post stmt, body stmt]
+	//  VAR: lhs var record
+	//  ASSIGN: tkn op, lhs list of exprs, rhs list of exprs
+	//  BLOCK: lhs list of stmts
+	// decls, tkn is the name of all of them:
+	//  VAR: lhs var record
+	//  FUNC: lhs [ret type sign, body stmt, count, field record...]
+	//  TYPE: lhs type sign
+	// types:
+	//  NAMED, ARRAY: tkn
+	//  PTR: nothing
+	//  STRUCT, UNION: lhs list of field records
+	//  ENUM: lhs [count, (id tkn, expr)...]
+	//  FUNC: lhs list of type signs, rhs ret type sign
+	// records in extra:
+	//  type sign: list of types
+	//  field record: [ids count, id tkn..., type sign], function args use it as well
+	//  var record: [ids count, id tkn..., type sign, list of exprs]
+	struct Flat_AST
+	{
+		Tkn package;
+		mn::Buf<Tkn> tkns;
+		mn::Buf<Flat_Node> exprs;
+		mn::Buf<Flat_Node> stmts;
+		// only the top level decls in declaration order
+		mn::Buf<Flat_Node> decls;
+		mn::Buf<Flat_Node> types;
+		mn::Buf<uint32_t> extra;
+	};
+
+	ZAY_EXPORT Flat_AST
+	flat_ast_new();
+
+	ZAY_EXPORT void
+	flat_ast_free(Flat_AST& self);
+
+	inline static void
+	destruct(Flat_AST& self)
+	{
+		flat_ast_free(self);
+	}
+
+	// flattens the given decl and its children into the flat ast and returns its index
+	ZAY_EXPORT Flat_Ix
+	flat_ast_decl(Flat_AST& self, Decl* decl);
+
+	// flattens the given expr and its children into the flat ast and returns its index
+	ZAY_EXPORT Flat_Ix
+	flat_ast_expr(Flat_AST& self, Expr* expr);
+
+	// flattens the given stmt and its children into the flat ast and returns its index
+	ZAY_EXPORT Flat_Ix
+	flat_ast_stmt(Flat_AST& self, Stmt* stmt);
+
+	// flattens the whole ast
+	ZAY_EXPORT Flat_AST
+	flat_ast_from(const AST& ast);
+}
\ No newline at end of file
@@ -2,33 +2,68 @@
 
 #include "zay/Exports.h"
 #include "zay/Src.h"
+#include "zay/scan/Scanner.h"
 #include "zay/parse/AST.h"
 
 #include <mn/Buf.h>
+#include <mn/Memory.h>
 
 #include <stddef.h>
 
 namespace zay
 {
+	// the parser looks at most 1 token ahead, so the ring holds the last eaten token, the current one
+	// and the one after it, must be a power of 2
+	constexpr size_t PARSER_RING_SIZE = 4;
+
+	// an id a streaming parser took for a non type because no typename had its name yet
+	struct Typename_Miss
+	{
+		const char* name;
+		// index of the top level declaration it was met in
+		size_t decl_ix;
+	};
+
+	// Parser doesn't own any memory, the nodes go into the AST arena and the typenames into the AST
+	// so there's nothing to free when you're done with it
 	struct Parser
 	{
 		Src *src;
-		mn::Buf<Tkn> tkns;
+		// index of the current token
 		size_t ix;
-		mn::Buf<Tkn> typenames;
+
+		// streaming parsers pull the tokens from the scanner, the others pull them from Src::tkns
+		bool streaming;
+		Scanner scanner;
+		// index of the next token to pull from Src::tkns
+		size_t tkns_ix;
+		// the tokens at and after this index in Src::tkns are never pulled, it's the tokens count unless
+		// the parser works on a slice of them
+		size_t tkns_end;
+		// the last pulled token of Src::tkns and its position, the positions of the next tokens are
+		// counted from it so they're never searched for in the line table
+		const char* tkns_it;
+		Pos tkns_pos;
+		// if set the errors go here instead of Src::errs, parsers running on other threads use it
+		mn::Buf<Err>* errs;
+		// if set the parser learns the typenames from the type declarations it parses instead of knowing
+		// them upfront, and the ids it takes for non types go here in parse order
+		mn::Buf<Typename_Miss>* typename_misses;
+		// ring buffer of the pulled tokens, token i lives in ring[i % PARSER_RING_SIZE]
+		Tkn ring[PARSER_RING_SIZE];
+		// number of tokens pulled so far
+		size_t ring_end;
 	};
 
+	// creates a parser over the already scanned tokens in Src::tkns
 	ZAY_EXPORT Parser
 	parser_new(Src *src);
 
-	ZAY_EXPORT void
-	parser_free(Parser& self);
-
-	inline static void
-	destruct(Parser& self)
-	{
-		parser_free(self);
-	}
+	// creates a parser which scans the source code while parsing, the tokens are never stored in Src::tkns
+	// it only knows the typenames which are already in the AST, src_scan_parse takes care of the typenames
+	// used before their declaration, check src_has_err before parsing since it validates the utf-8
+	ZAY_EXPORT Parser
+	parser_stream_new(Src *src);
 
 	ZAY_EXPORT Expr*
 	parser_expr(Parser& self);
@@ -42,24 +77,51 @@ namespace zay
 	ZAY_EXPORT Tkn
 	parser_pkg(Parser& self);
 
-	inline static bool
-	src_parse(Src *src, MODE mode)
+	ZAY_EXPORT bool
+	parser_eof(Parser& self);
+
+	// parses the body of a function which was skipped by a BODIES::LAZY parse, it does nothing if the body
+	// is already parsed, returns false if the body has syntax errors
+	ZAY_EXPORT bool
+	src_parse_func_body(Src *src, Decl* decl);
+
+	inline static void
+	parser_src(Parser& self, MODE mode)
 	{
-		auto self = parser_new(src);
+		//the nodes go into the AST arena, they're freed with the AST
+		mn::allocator_push(self.src->ast.arena);
 
 		//first parse the package declaration
 		if (mode != MODE::NONE)
-			src->ast.package = parser_pkg(self);
+			self.src->ast.package = parser_pkg(self);
 
 		//then everything else
-		while(self.ix < self.tkns.count)
+		while(parser_eof(self) == false)
 		{
 			if (Decl* d = parser_decl(self))
-				mn::buf_push(src->ast.decls, d);
+				mn::buf_push(self.src->ast.decls, d);
 			else
 				break;
 		}
-		parser_free(self);
-		return src_has_err(src) == false;
+
+		mn::allocator_pop();
 	}
+
+	// parses Src::tkns into Src::ast, big token stores are parsed in parallel using src_parse_parallel
+	ZAY_EXPORT bool
+	src_parse(Src *src, MODE mode);
+
+	// parses Src::tkns using the given number of threads, the tokens are split at top level declarations
+	// and every slice is parsed into its own arena, the AST and errors are exactly the same as parsing
+	// it sequentially
+	ZAY_EXPORT bool
+	src_parse_parallel(Src *src, MODE mode, size_t slices_count);
+
+	// scans and parses the source code in one go without storing the tokens, use it instead of src_scan + src_parse
+	// the typenames are learned while parsing, the declarations which took a typename used before its
+	// declaration for something else are parsed again once the whole code is scanned
+	// files big enough for src_scan to split into chunks are scanned into Src::tkns then parsed by src_parse
+	// so both the scan and the parse run in parallel
+	ZAY_EXPORT bool
+	src_scan_parse(Src *src, MODE mode);
 }
\ No newline at end of file
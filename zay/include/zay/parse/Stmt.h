@@ -108,6 +108,39 @@ namespace zay
 	ZAY_EXPORT Expr*
 	stmt_expr_decay(Stmt* expr);
 
+	// Stmt_Walk_Frame is a stmt which is being walked and the number of times it was visited
+	struct Stmt_Walk_Frame
+	{
+		Stmt* stmt;
+		size_t step;
+	};
+
+	// returns the child stmt at the given index in evaluation order or nullptr if there's none, the missing
+	// children like a for stmt without an init stmt are skipped
+	ZAY_EXPORT Stmt*
+	stmt_child(Stmt* self, size_t ix);
+
+	// walks the stmt tree without recursion like expr_walk does for exprs, visit is called with step 0 when
+	// the walk enters a stmt then with step i after the walk is done with the i-th child it returned, it
+	// returns the next child to walk or nullptr once the stmt is done
+	template<typename T>
+	inline static void
+	stmt_walk(mn::Buf<Stmt_Walk_Frame>& stack, Stmt* root, T& ctx, Stmt* (*visit)(T&, Stmt*, size_t))
+	{
+		size_t base = stack.count;
+		mn::buf_push(stack, Stmt_Walk_Frame{root, 0});
+		while(stack.count > base)
+		{
+			//visit may walk other stmts which can move the stack so don't hold on to the frame
+			Stmt_Walk_Frame frame = stack[stack.count - 1];
+			stack[stack.count - 1].step++;
+			if(Stmt* child = visit(ctx, frame.stmt, frame.step))
+				mn::buf_push(stack, Stmt_Walk_Frame{child, 0});
+			else
+				mn::buf_pop(stack);
+		}
+	}
+
 	ZAY_EXPORT void
 	stmt_free(Stmt* self);
 
@@ -2,16 +2,23 @@
 
 #include "zay/Exports.h"
 #include "zay/scan/Tkn.h"
+#include "zay/Small_Buf.h"
 
 #include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Thread.h>
 
 namespace zay
 {
 	struct Field;
 	struct Enum_Field;
+	struct Type;
 
 	struct Type_Atom;
-	typedef mn::Buf<Type_Atom> Type_Sign;
+	struct Type_Sign_Node;
+	// a null type sign means no type was written
+	typedef Type_Sign_Node* Type_Sign;
 
 	//Types
 	struct Type_Atom
@@ -77,24 +84,156 @@ namespace zay
 	clone(const Type_Atom& self);
 
 
+	// Type_Sign_Node is the type sign as written, the atoms are in reading order so *[4]int is ptr, array
+	// then named, signs which are made of named, ptr, array and func atoms are interned so all of their
+	// uses share the same immutable node and two of them are the same if their pointers are the same
+	struct Type_Sign_Node
+	{
+		mn::Buf<Type_Atom> atoms;
+		// the typer caches the resolved type here so a shared sign is resolved once
+		Type* type;
+		// interned nodes are owned by the Type_Sign_Table, the others are owned by their user
+		bool interned;
+	};
+
+	// frees the type sign unless it's interned then it just forgets about it
+	ZAY_EXPORT void
+	type_sign_free(Type_Sign& self);
+
+	inline static void
+	destruct(Type_Sign& self)
+	{
+		type_sign_free(self);
+	}
+
+	// interned signs are immutable so they're shared instead of copied
+	ZAY_EXPORT Type_Sign
+	clone(const Type_Sign& self);
 
-	inline static Type_Sign
-	type_sign_new()
+	// whether the atoms are the same, it only handles the atoms of interned signs, the names and the array
+	// counts are interned strings and the func args are interned signs so they're all compared by pointer
+	inline static bool
+	type_atom_same(const Type_Atom& a, const Type_Atom& b)
 	{
-		return mn::buf_new<Type_Atom>();
+		if(a.kind != b.kind)
+			return false;
+
+		switch(a.kind)
+		{
+		case Type_Atom::KIND_NAMED:
+			return a.named.str == b.named.str;
+		case Type_Atom::KIND_ARRAY:
+			return a.count.kind == b.count.kind && a.count.str == b.count.str;
+		case Type_Atom::KIND_FUNC:
+			if(a.func.args.count != b.func.args.count || a.func.ret != b.func.ret)
+				return false;
+			for(size_t i = 0; i < a.func.args.count; ++i)
+				if(a.func.args[i] != b.func.args[i])
+					return false;
+			return true;
+		default:
+			return true;
+		}
 	}
 
+	// key of the interned signs, it hashes and compares the atoms not their address
+	struct Type_Sign_Key
+	{
+		const mn::Buf<Type_Atom>* atoms;
+
+		inline bool
+		operator==(const Type_Sign_Key& other) const
+		{
+			if(atoms->count != other.atoms->count)
+				return false;
+
+			for(size_t i = 0; i < atoms->count; ++i)
+				if(type_atom_same((*atoms)[i], (*other.atoms)[i]) == false)
+					return false;
+
+			return true;
+		}
+
+		inline bool
+		operator!=(const Type_Sign_Key& other) const
+		{
+			return !operator==(other);
+		}
+	};
+
+	struct Type_Sign_Key_Hasher
+	{
+		inline size_t
+		operator()(const Type_Sign_Key& key) const
+		{
+			size_t res = mn::Hash<size_t>()(key.atoms->count);
+			for(const Type_Atom& atom: *key.atoms)
+			{
+				res = mn::hash_mix(res, mn::Hash<size_t>()(size_t(atom.kind)));
+				if(atom.kind == Type_Atom::KIND_NAMED)
+				{
+					//names are interned so their address is enough
+					res = mn::hash_mix(res, mn::Hash<size_t>()(size_t(atom.named.str)));
+				}
+				else if(atom.kind == Type_Atom::KIND_ARRAY)
+				{
+					res = mn::hash_mix(res, mn::Hash<size_t>()(size_t(atom.count.str)));
+				}
+				else if(atom.kind == Type_Atom::KIND_FUNC)
+				{
+					for(Type_Sign arg: atom.func.args)
+						res = mn::hash_mix(res, mn::Hash<Type_Sign>()(arg));
+					res = mn::hash_mix(res, mn::Hash<Type_Sign>()(atom.func.ret));
+				}
+			}
+			return res;
+		}
+	};
+
+	// Type_Sign_Table hash-conses the type signs of a compilation unit, it's thread safe because the
+	// parallel parse interns from many threads at once
+	struct Type_Sign_Table
+	{
+		mn::Mutex mtx;
+		// the interned nodes and their atoms live here
+		mn::Allocator arena;
+		mn::Map<Type_Sign_Key, Type_Sign, Type_Sign_Key_Hasher> nodes;
+	};
+
+	ZAY_EXPORT Type_Sign_Table
+	type_sign_table_new();
+
+	ZAY_EXPORT void
+	type_sign_table_free(Type_Sign_Table& self);
+
 	inline static void
-	type_sign_free(Type_Sign& self)
+	destruct(Type_Sign_Table& self)
+	{
+		type_sign_table_free(self);
+	}
+
+	// makes a type sign out of the given atoms and takes their ownership, it returns the interned node if
+	// the sign can be shared, a node of its own if it has struct, union or enum atoms which declare a new
+	// type at every use, or null if there are no atoms
+	ZAY_EXPORT Type_Sign
+	type_sign_from(Type_Sign_Table& table, mn::Buf<Type_Atom>& atoms);
+
+	// number of atoms in the type sign, it's 0 if no type was written
+	inline static size_t
+	type_sign_count(const Type_Sign& self)
 	{
-		mn::destruct(self);
+		return self ? self->atoms.count : 0;
 	}
 
 
+	// the ids of a field, var or function arg, a token is 40 bytes and most lists hold a single id so only
+	// the first one is stored inline, the rest go to the heap
+	typedef Small_Buf<Tkn, 1> Id_List;
+
 	//Struct, Union Fields
 	struct Field
 	{
-		mn::Buf<Tkn> ids;
+		Id_List ids;
 		Type_Sign type;
 	};
 
@@ -102,15 +241,15 @@ namespace zay
 	field_new()
 	{
 		Field self{};
-		self.ids = mn::buf_new<Tkn>();
-		self.type = type_sign_new();
+		self.ids = small_buf_new<Id_List>();
+		self.type = nullptr;
 		return self;
 	}
 
 	inline static void
 	field_free(Field& self)
 	{
-		mn::buf_free(self.ids);
+		small_buf_free(self.ids);
 		type_sign_free(self.type);
 	}
 
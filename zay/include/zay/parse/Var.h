@@ -11,7 +11,7 @@ namespace zay
 
 	struct Var
 	{
-		mn::Buf<Tkn> ids;
+		Id_List ids;
 		Type_Sign type;
 		mn::Buf<Expr*> exprs;
 	};
@@ -20,8 +20,8 @@ namespace zay
 	var_new()
 	{
 		return Var{
-			mn::buf_new<Tkn>(),
-			type_sign_new(),
+			small_buf_new<Id_List>(),
+			nullptr,
 			mn::buf_new<Expr*>()
 		};
 	}
@@ -29,7 +29,7 @@ namespace zay
 	inline static void
 	var_free(Var& self)
 	{
-		mn::buf_free(self.ids);
+		small_buf_free(self.ids);
 		type_sign_free(self.type);
 		destruct(self.exprs);
 	}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "zay/Exports.h"
+
+#include <mn/Str.h>
+
+#include <stdint.h>
+
+namespace zay
+{
+	// decodes the integer literal in [begin, end) which may have a 0b, 0o, 0d, or 0x base prefix
+	// it returns false if the value doesn't fit in 64 bits
+	ZAY_EXPORT bool
+	literal_int_decode(const char* begin, const char* end, uint64_t& value);
+
+	// decodes the float literal in [begin, end)
+	ZAY_EXPORT double
+	literal_float_decode(const char* begin, const char* end);
+
+	// decodes the escapes of the string literal body in [begin, end) (without the quotes) into out
+	// it decodes the escapes C has, any other escape is left as it's spelled in the body
+	ZAY_EXPORT void
+	literal_string_decode(const char* begin, const char* end, mn::Str& out);
+}
\ No newline at end of file
@@ -15,8 +15,18 @@ namespace zay
 		const char* it;
 		// Rune is a utf-8 codepoint (A character)
 		mn::Rune c;
-		// position of the current character
+		// position of the current character, the column is only synced when a token begins
 		Pos pos;
+		// the point in the source code the column was last synced at
+		const char* col_it;
+		// detached scanners report errors here instead of the src and don't intern strings
+		mn::Buf<Err>* errs;
+		// comments are skipped and their ranges are pushed here when it's set, otherwise they're tokens
+		mn::Buf<Trivia>* trivia;
+		// the decoded values of the literals are pushed here when it's set
+		mn::Buf<Tkn_Value>* values;
+		// number of errors reported so far
+		size_t errs_count;
 	};
 
 	inline static Scanner
@@ -25,10 +35,12 @@ namespace zay
 		Scanner self{};
 		self.src = src;
 		self.it = begin(self.src->content);
-		self.c = mn::rune_read(self.it);
+		self.c = self.it < end(self.src->content) ? mn::rune_read(self.it) : 0;
 		self.pos = Pos{1, 0};
-
-		src_line_begin(self.src, self.it);
+		self.col_it = self.it;
+		if(src->comments == COMMENTS::TRIVIA)
+			self.trivia = &src->tkns.trivia;
+		self.values = &src->tkns.values;
 		return self;
 	}
 
@@ -41,17 +53,25 @@ namespace zay
 	ZAY_EXPORT Tkn
 	scanner_tkn(Scanner *self);
 
-	inline static bool
-	src_scan(Src *src)
-	{
-		auto self = scanner_new(src);
-		while(true)
-		{
-			if(Tkn tkn = scanner_tkn(&self))
-				src_tkn(src, tkn);
-			else
-				break;
-		}
-		return src_has_err(src) == false;
-	}
+	// reports an error at the first invalid utf-8 sequence of the src content, the scanner assumes valid utf-8
+	// so src_scan and src_scan_chunked call it before scanning, other users of scanner_tkn must call it themselves
+	ZAY_EXPORT bool
+	src_validate_utf8(Src *src);
+
+	// returns the number of chunks src_scan splits the src into, it's 1 if the src is scanned sequentially
+	ZAY_EXPORT size_t
+	src_scan_chunks_count(const Src *src);
+
+	// scans the src into Src::tkns, big files are split into chunks which are scanned in parallel
+	ZAY_EXPORT bool
+	src_scan(Src *src);
+
+	// scans the src into Src::tkns using the given number of chunks, the tokens and errors are
+	// exactly the same as scanning it sequentially
+	ZAY_EXPORT bool
+	src_scan_chunked(Src *src, size_t chunks_count);
+	// replaces the content [begin_offset, end_offset) with the given text and only rescans the tokens
+	// around the edit, the resulting tokens and errors are the same as scanning the new content from scratch
+	ZAY_EXPORT bool
+	src_edit(Src *src, size_t begin_offset, size_t end_offset, const char* text, size_t text_count);
 }
\ No newline at end of file
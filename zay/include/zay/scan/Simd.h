@@ -0,0 +1,228 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define ZAY_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define ZAY_SIMD_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace zay
+{
+	// returns the number of set bits
+	inline static uint32_t
+	bit_count(uint32_t x)
+	{
+	#if defined(_MSC_VER)
+		x = x - ((x >> 1) & 0x55555555);
+		x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+		return (((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+	#else
+		return __builtin_popcount(x);
+	#endif
+	}
+
+	// returns the index of the first set bit, x must not be 0
+	inline static uint32_t
+	bit_first(uint32_t x)
+	{
+	#if defined(_MSC_VER)
+		unsigned long ix = 0;
+		_BitScanForward(&ix, x);
+		return ix;
+	#else
+		return __builtin_ctz(x);
+	#endif
+	}
+
+	// returns the index of the last set bit, x must not be 0
+	inline static uint32_t
+	bit_last(uint32_t x)
+	{
+	#if defined(_MSC_VER)
+		unsigned long ix = 0;
+		_BitScanReverse(&ix, x);
+		return ix;
+	#else
+		return 31 - __builtin_clz(x);
+	#endif
+	}
+
+	// block kernels, each one loads BLOCK_SIZE bytes and returns a mask with bit i set if the byte at it + i matches
+	// there's no alignment requirement, callers must make sure that BLOCK_SIZE bytes are available
+	#if ZAY_SIMD_AVX2
+		#define ZAY_SIMD 1
+		constexpr size_t BLOCK_SIZE = 32;
+		constexpr uint32_t BLOCK_FULL = 0xFFFFFFFF;
+
+		inline static uint32_t
+		block_match(const char* it, char c)
+		{
+			__m256i block = _mm256_loadu_si256((const __m256i*)it);
+			return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+		}
+
+		inline static uint32_t
+		block_match(const char* it, char a, char b, char c)
+		{
+			__m256i block = _mm256_loadu_si256((const __m256i*)it);
+			__m256i res = _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_cmpeq_epi8(block, _mm256_set1_epi8(a)),
+					_mm256_cmpeq_epi8(block, _mm256_set1_epi8(b))
+				),
+				_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))
+			);
+			return uint32_t(_mm256_movemask_epi8(res));
+		}
+
+		inline static uint32_t
+		block_whitespace(const char* it)
+		{
+			__m256i block = _mm256_loadu_si256((const __m256i*)it);
+			// ' ' or one of '\t', '\n', '\v' which are contiguous, or '\r'
+			__m256i res = _mm256_or_si256(
+				_mm256_or_si256(
+					_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+					_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))
+				),
+				_mm256_cmpeq_epi8(
+					_mm256_min_epu8(_mm256_sub_epi8(block, _mm256_set1_epi8('\t')), _mm256_set1_epi8(2)),
+					_mm256_sub_epi8(block, _mm256_set1_epi8('\t'))
+				)
+			);
+			return uint32_t(_mm256_movemask_epi8(res));
+		}
+
+		inline static uint32_t
+		block_non_ascii(const char* it)
+		{
+			//the mask is just the high bits of the bytes
+			return uint32_t(_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)it)));
+		}
+	#elif ZAY_SIMD_SSE2
+		#define ZAY_SIMD 1
+		constexpr size_t BLOCK_SIZE = 16;
+		constexpr uint32_t BLOCK_FULL = 0xFFFF;
+
+		inline static uint32_t
+		block_match(const char* it, char c)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)it);
+			return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+		}
+
+		inline static uint32_t
+		block_match(const char* it, char a, char b, char c)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)it);
+			__m128i res = _mm_or_si128(
+				_mm_or_si128(
+					_mm_cmpeq_epi8(block, _mm_set1_epi8(a)),
+					_mm_cmpeq_epi8(block, _mm_set1_epi8(b))
+				),
+				_mm_cmpeq_epi8(block, _mm_set1_epi8(c))
+			);
+			return uint32_t(_mm_movemask_epi8(res));
+		}
+
+		inline static uint32_t
+		block_whitespace(const char* it)
+		{
+			__m128i block = _mm_loadu_si128((const __m128i*)it);
+			// ' ' or one of '\t', '\n', '\v' which are contiguous, or '\r'
+			__m128i res = _mm_or_si128(
+				_mm_or_si128(
+					_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+					_mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))
+				),
+				_mm_cmpeq_epi8(
+					_mm_min_epu8(_mm_sub_epi8(block, _mm_set1_epi8('\t')), _mm_set1_epi8(2)),
+					_mm_sub_epi8(block, _mm_set1_epi8('\t'))
+				)
+			);
+			return uint32_t(_mm_movemask_epi8(res));
+		}
+
+		inline static uint32_t
+		block_non_ascii(const char* it)
+		{
+			//the mask is just the high bits of the bytes
+			return uint32_t(_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)it)));
+		}
+	#endif
+
+	// returns the first occurance of c in the range or end_it if it's not there
+	inline static const char*
+	find_byte(const char* it, const char* end_it, char c)
+	{
+	#if ZAY_SIMD
+		for(; size_t(end_it - it) >= BLOCK_SIZE; it += BLOCK_SIZE)
+		{
+			if(uint32_t mask = block_match(it, c))
+				return it + bit_first(mask);
+		}
+	#endif
+		for(; it < end_it; ++it)
+			if(*it == c)
+				return it;
+		return end_it;
+	}
+
+	// returns the first occurance of any of a, b, or c in the range or end_it if none of them is there
+	inline static const char*
+	find_byte(const char* it, const char* end_it, char a, char b, char c)
+	{
+	#if ZAY_SIMD
+		for(; size_t(end_it - it) >= BLOCK_SIZE; it += BLOCK_SIZE)
+		{
+			if(uint32_t mask = block_match(it, a, b, c))
+				return it + bit_first(mask);
+		}
+	#endif
+		for(; it < end_it; ++it)
+			if(*it == a || *it == b || *it == c)
+				return it;
+		return end_it;
+	}
+
+	// returns the first byte with the high bit set in the range or end_it if it's all ascii
+	inline static const char*
+	find_non_ascii(const char* it, const char* end_it)
+	{
+	#if ZAY_SIMD
+		for(; size_t(end_it - it) >= BLOCK_SIZE; it += BLOCK_SIZE)
+		{
+			if(uint32_t mask = block_non_ascii(it))
+				return it + bit_first(mask);
+		}
+	#endif
+		for(; it < end_it; ++it)
+			if(uint8_t(*it) >= 0x80)
+				return it;
+		return end_it;
+	}
+
+	// returns the number of occurances of c in the range
+	inline static size_t
+	count_byte(const char* it, const char* end_it, char c)
+	{
+		size_t res = 0;
+	#if ZAY_SIMD
+		for(; size_t(end_it - it) >= BLOCK_SIZE; it += BLOCK_SIZE)
+			res += bit_count(block_match(it, c));
+	#endif
+		for(; it < end_it; ++it)
+			if(*it == c)
+				++res;
+		return res;
+	}
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "zay/scan/Rng.h"
 #include "zay/scan/Token_Listing.h"
 
+#include <stdint.h>
+
 namespace zay
 {
 	// Tkn is a zay source code token
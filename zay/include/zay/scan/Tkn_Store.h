@@ -0,0 +1,99 @@
+#pragma once
+
+#include "zay/Exports.h"
+#include "zay/scan/Tkn.h"
+
+#include <mn/Buf.h>
+
+#include <stdint.h>
+
+namespace zay
+{
+	// Trivia is a piece of the source code which the parser doesn't care about, only comments for now
+	struct Trivia
+	{
+		// offset of the first byte in the source code
+		uint32_t offset;
+		// length in bytes, it doesn't include the \n at the end of the comment
+		uint32_t len;
+	};
+
+	// Tkn_Value is the value of a literal token decoded by the scanner
+	struct Tkn_Value
+	{
+		// offset of the literal token in the source code
+		uint32_t offset;
+		// byte count of the decoded string, it might contain '\0' so it can't be strlen'ed
+		uint32_t count;
+		// integer for KIND_INTEGER, real for KIND_FLOAT, and the interned unescaped bytes for KIND_STRING
+		union
+		{
+			uint64_t integer;
+			double real;
+			const char* string;
+		};
+	};
+
+	// Tkn_Store is a compact structure of arrays storage of tokens, it only stores the kind, the offset
+	// and the length of each token (9 bytes per token), the rest of the token is derived on demand
+	// from the source code using src_tkn_at
+	struct Tkn_Store
+	{
+		mn::Buf<uint8_t> kinds;
+		// offset of the first byte of the token in the source code
+		mn::Buf<uint32_t> offsets;
+		// length of the token in bytes
+		mn::Buf<uint32_t> lens;
+		// comments scanned as trivia sorted by offset, they don't show up in the tokens
+		mn::Buf<Trivia> trivia;
+		// decoded values of the literal tokens sorted by offset, the scanner fills it even when the tokens
+		// themselves aren't stored
+		mn::Buf<Tkn_Value> values;
+	};
+
+	ZAY_EXPORT Tkn_Store
+	tkn_store_new();
+
+	ZAY_EXPORT void
+	tkn_store_free(Tkn_Store& self);
+
+	inline static void
+	destruct(Tkn_Store& self)
+	{
+		tkn_store_free(self);
+	}
+
+	// pushes the given token into the store, base is the beginning of the source code of the token
+	ZAY_EXPORT void
+	tkn_store_push(Tkn_Store& self, const char* base, const Tkn& tkn);
+
+	// replaces the tokens [first, last) with the given tokens and moves the offsets of the tokens after them by shift
+	ZAY_EXPORT void
+	tkn_store_splice(Tkn_Store& self, size_t first, size_t last, const Tkn_Store& tkns, int64_t shift);
+
+	// replaces the trivia [first, last) with the given trivia and moves the offsets of the trivia after them by shift
+	ZAY_EXPORT void
+	tkn_store_trivia_splice(Tkn_Store& self, size_t first, size_t last, const mn::Buf<Trivia>& trivia, int64_t shift);
+
+	// replaces the values [first, last) with the given values and moves the offsets of the values after them by shift
+	ZAY_EXPORT void
+	tkn_store_values_splice(Tkn_Store& self, size_t first, size_t last, const mn::Buf<Tkn_Value>& values, int64_t shift);
+
+	// returns the index of the first value which begins at or after the given offset
+	ZAY_EXPORT size_t
+	tkn_store_values_lower_bound(const Tkn_Store& self, size_t offset);
+
+	// returns the decoded value of the literal token at the given offset, it's zero if the token has none
+	ZAY_EXPORT Tkn_Value
+	tkn_store_value(const Tkn_Store& self, size_t offset);
+
+	// returns the index of the first token which begins at or after the given offset
+	ZAY_EXPORT size_t
+	tkn_store_lower_bound(const Tkn_Store& self, size_t offset);
+
+	inline static size_t
+	tkn_store_count(const Tkn_Store& self)
+	{
+		return self.kinds.count;
+	}
+}
\ No newline at end of file
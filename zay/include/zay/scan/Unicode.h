@@ -0,0 +1,21 @@
+#pragma once
+
+#include "zay/Exports.h"
+
+#include <mn/Rune.h>
+
+namespace zay
+{
+	// returns whether the rune can begin an identifier, which is XID_Start or '_'
+	ZAY_EXPORT bool
+	rune_is_id_start(mn::Rune c);
+
+	// returns whether the rune can be in an identifier after the first rune, which is XID_Continue
+	ZAY_EXPORT bool
+	rune_is_id_continue(mn::Rune c);
+
+	// returns the first byte of the first invalid utf-8 sequence in the range or end if it's all valid
+	// truncated sequences, overlong encodings, surrogates, and runes beyond U+10FFFF are invalid
+	ZAY_EXPORT const char*
+	utf8_validate(const char* begin, const char* end);
+}
\ No newline at end of file
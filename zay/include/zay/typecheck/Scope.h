@@ -4,7 +4,6 @@
 #include "zay/typecheck/Sym.h"
 
 #include <mn/Buf.h>
-#include <mn/Map.h>
 
 namespace zay
 {
@@ -12,7 +11,9 @@ namespace zay
 	{
 		Scope* parent;
 		mn::Buf<Sym*> syms;
-		mn::Map<const char*, Sym*> table;
+		// open addressing table of the syms keyed by their interned name, it's empty until the first
+		// sym is added then its count is always a power of 2
+		mn::Buf<Sym*> table;
 		bool inside_loop;
 		Type* ret;
 	};
@@ -29,6 +30,7 @@ namespace zay
 		scope_free(self);
 	}
 
+	// the names must be interned in the intern pool, the lookups use the hash which is stored with them
 	ZAY_EXPORT Sym*
 	scope_has(Scope* self, const char* name);
 
@@ -2,6 +2,7 @@
 
 #include "zay/Exports.h"
 #include "zay/typecheck/Sym.h"
+#include "zay/Small_Buf.h"
 
 #include <mn/Buf.h>
 #include <mn/Map.h>
@@ -16,7 +17,8 @@ namespace zay
 	//function types is the aggregate of their argument types and return type
 	struct Func_Sign
 	{
-		mn::Buf<Type*> args;
+		// the args of most functions fit inline which saves an allocation per function type
+		Small_Buf<Type*, 4> args;
 		Type* ret;
 
 		inline bool
@@ -45,13 +47,15 @@ namespace zay
 	inline static Func_Sign
 	func_sign_new()
 	{
-		return Func_Sign { mn::buf_new<Type*>(), nullptr };
+		Func_Sign self{};
+		self.args = small_buf_new<Small_Buf<Type*, 4>>();
+		return self;
 	}
 
 	inline static void
 	func_sign_free(Func_Sign& self)
 	{
-		mn::buf_free(self.args);
+		small_buf_free(self.args);
 	}
 
 	inline static void
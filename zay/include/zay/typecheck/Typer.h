@@ -24,6 +24,11 @@ namespace zay
 		Scope* global_scope;
 
 		size_t unnamed_id;
+
+		// frames of the expr walks, it's kept around so resolving exprs doesn't allocate
+		mn::Buf<Expr_Walk_Frame> expr_stack;
+		// frames of the stmt walks, deeply nested stmts don't grow the call stack
+		mn::Buf<Stmt_Walk_Frame> stmt_stack;
 	};
 
 	ZAY_EXPORT Typer
@@ -379,7 +379,17 @@ namespace zay
 	cgen_expr_atom(CGen& self, Expr* expr)
 	{
 		assert(expr->kind == Expr::KIND_ATOM);
-		if(auto sym = cgen_sym(self, expr->atom.str))
+		//only ids are in the scopes, the other atoms are written as they are
+		Sym* sym = nullptr;
+		if(expr->atom.kind == Tkn::KIND_ID)
+			sym = cgen_sym(self, expr->atom.str);
+
+		if(expr->atom.kind == Tkn::KIND_INTEGER)
+		{
+			//C has no 0b, 0o, or 0d prefixes so write the decoded value instead of the spelling
+			mn::print_to(self.out, "{}", src_tkn_value(self.src, expr->atom).integer);
+		}
+		else if(sym)
 		{
 			mn::print_to(self.out, "{}", sym->package_name);
 		}
@@ -389,157 +399,196 @@ namespace zay
 		}
 	}
 
-	inline static void
-	cgen_expr_binary(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_binary(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_BINARY);
-		cgen_expr_gen(self, expr->binary.lhs);
-		mn::print_to(self.out, " {} ", expr->binary.op.str);
-		cgen_expr_gen(self, expr->binary.rhs);
+		if(step == 0)
+			return expr->binary.lhs;
+
+		if(step == 1)
+		{
+			mn::print_to(self.out, " {} ", expr->binary.op.str);
+			return expr->binary.rhs;
+		}
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_unary(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_unary(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_UNARY);
-		mn::print_to(self.out, "{}", expr->unary.op.str);
-		cgen_expr_gen(self, expr->unary.expr);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "{}", expr->unary.op.str);
+			return expr->unary.expr;
+		}
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_dot(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_dot(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_DOT);
-		cgen_expr_gen(self, expr->dot.base);
+		if(step == 0)
+			return expr->dot.base;
+
 		if(expr->dot.base->type->kind == Type::KIND_ENUM)
 			mn::print_to(self.out, "::{}", expr->dot.member.str);
 		else if(expr->dot.base->type->kind == Type::KIND_PTR)
 			mn::print_to(self.out, "->{}", expr->dot.member.str);
 		else
 			mn::print_to(self.out, ".{}", expr->dot.member.str);
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_indexed(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_indexed(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_INDEXED);
-		cgen_expr_gen(self, expr->indexed.base);
-		mn::print_to(self.out, "[");
-		cgen_expr_gen(self, expr->indexed.index);
+		if(step == 0)
+			return expr->indexed.base;
+
+		if(step == 1)
+		{
+			mn::print_to(self.out, "[");
+			return expr->indexed.index;
+		}
 		mn::print_to(self.out, "]");
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_call(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_call(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_CALL);
-		cgen_expr_gen(self, expr->call.base);
-		mn::print_to(self.out, "(");
-		for(size_t i = 0; i < expr->call.args.count; ++i)
+		if(step == 0)
+			return expr->call.base;
+
+		//step i comes once the base and the first i - 1 args are written
+		if(step == 1)
+			mn::print_to(self.out, "(");
+		if(step - 1 < expr->call.args.count)
 		{
-			if (i != 0)
+			if (step != 1)
 				mn::print_to(self.out, ", ");
-			cgen_expr_gen(self, expr->call.args[i]);
+			return expr->call.args[step - 1];
 		}
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_cast(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_cast(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_CAST);
-		mn::print_to(self.out, "({})", cgen_write_field(self, expr->type, ""));
-		cgen_expr_gen(self, expr->cast.base);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "({})", cgen_write_field(self, expr->type, ""));
+			return expr->cast.base;
+		}
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_paren(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_paren(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_PAREN);
-		mn::print_to(self.out, "(");
-		cgen_expr_gen(self, expr->paren);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(");
+			return expr->paren;
+		}
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_complit(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_complit_field_begin(CGen& self, Expr* expr, size_t i)
+	{
+		if(i != 0)
+			mn::print_to(self.out, ",");
+		cgen_newline(self);
+		if (expr->complit.fields[i].kind == Complit_Field::KIND_MEMBER)
+			mn::print_to(self.out, ".");
+		else if(expr->complit.fields[i].kind == Complit_Field::KIND_ARRAY)
+			mn::print_to(self.out, "[");
+		return expr->complit.fields[i].left;
+	}
+
+	//the fields are walked left then right so step 2i + 1 comes after the left of field i and step 2i + 2
+	//after its right
+	inline static Expr*
+	cgen_expr_complit(CGen& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_COMPLIT);
-		if(expr->type->kind != Type::KIND_ARRAY)
-			mn::print_to(self.out, "({})", cgen_write_field(self, expr->type, ""));
-		mn::print_to(self.out, "{{");
-		self.indent++;
-		for (size_t i = 0; i < expr->complit.fields.count; ++i)
+		if(step == 0)
 		{
-			if(i != 0)
-				mn::print_to(self.out, ",");
-			cgen_newline(self);
-			if (expr->complit.fields[i].kind == Complit_Field::KIND_MEMBER)
-			{
-				mn::print_to(self.out, ".");
-				cgen_expr_gen(self, expr->complit.fields[i].left);
-			}
-			else if(expr->complit.fields[i].kind == Complit_Field::KIND_ARRAY)
-			{
-				mn::print_to(self.out, "[");
-				cgen_expr_gen(self, expr->complit.fields[i].left);
+			if(expr->type->kind != Type::KIND_ARRAY)
+				mn::print_to(self.out, "({})", cgen_write_field(self, expr->type, ""));
+			mn::print_to(self.out, "{{");
+			self.indent++;
+		}
+		else if(step % 2 == 1)
+		{
+			const Complit_Field& field = expr->complit.fields[step / 2];
+			if(field.kind == Complit_Field::KIND_ARRAY)
 				mn::print_to(self.out, "]");
-			}
 			mn::print_to(self.out, " = ");
-			cgen_expr_gen(self, expr->complit.fields[i].right);
+			return field.right;
 		}
+
+		if(step / 2 < expr->complit.fields.count)
+			return cgen_complit_field_begin(self, expr, step / 2);
+
 		self.indent--;
 		if(expr->complit.fields.count > 0)
 			cgen_newline(self);
 		mn::print_to(self.out, "}}");
+		return nullptr;
 	}
 
-	inline static void
-	cgen_expr_gen(CGen& self, Expr* expr)
+	inline static Expr*
+	cgen_expr_visit(CGen& self, Expr* expr, size_t step)
 	{
 		switch(expr->kind)
 		{
 		case Expr::KIND_ATOM:
 			cgen_expr_atom(self, expr);
-			break;
+			return nullptr;
 		case Expr::KIND_BINARY:
-			cgen_expr_binary(self, expr);
-			break;
+			return cgen_expr_binary(self, expr, step);
 		case Expr::KIND_UNARY:
-			cgen_expr_unary(self, expr);
-			break;
+			return cgen_expr_unary(self, expr, step);
 		case Expr::KIND_DOT:
-			cgen_expr_dot(self, expr);
-			break;
+			return cgen_expr_dot(self, expr, step);
 		case Expr::KIND_INDEXED:
-			cgen_expr_indexed(self, expr);
-			break;
+			return cgen_expr_indexed(self, expr, step);
 		case Expr::KIND_CALL:
-			cgen_expr_call(self, expr);
-			break;
+			return cgen_expr_call(self, expr, step);
 		case Expr::KIND_CAST:
-			cgen_expr_cast(self, expr);
-			break;
+			return cgen_expr_cast(self, expr, step);
 		case Expr::KIND_PAREN:
-			cgen_expr_paren(self, expr);
-			break;
+			return cgen_expr_paren(self, expr, step);
 		case Expr::KIND_COMPLIT:
-			cgen_expr_complit(self, expr);
-			break;
+			return cgen_expr_complit(self, expr, step);
 		default:
 			assert(false && "unreachable");
-			break;
+			return nullptr;
 		}
 	}
 
+	inline static void
+	cgen_expr_gen(CGen& self, Expr* expr)
+	{
+		expr_walk(self.expr_stack, expr, self, cgen_expr_visit);
+	}
+
 
 	//Stmts
 	inline static void
 	cgen_stmt_gen(CGen& self, Stmt* stmt);
 
-	inline static void
-	cgen_stmt_block_gen(CGen& self, Stmt* stmt);
-
 	inline static void
 	cgen_stmt_return(CGen& self, Stmt* stmt)
 	{
@@ -555,67 +604,80 @@ namespace zay
 		}
 	}
 
-	inline static void
-	cgen_stmt_if(CGen& self, Stmt* stmt)
+	//step 0 writes the if condition and step i the condition of the i-th else if, each before its body
+	inline static Stmt*
+	cgen_stmt_if_visit(CGen& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_IF);
-
-		mn::print_to(self.out, "if (");
-		cgen_expr_gen(self, stmt->if_stmt.if_cond);
-		mn::print_to(self.out, ") ");
-		cgen_stmt_gen(self, stmt->if_stmt.if_body);
-
-		for(const Else_If& e: stmt->if_stmt.else_ifs)
+		const auto& else_ifs = stmt->if_stmt.else_ifs;
+		if(step == 0)
+		{
+			mn::print_to(self.out, "if (");
+			cgen_expr_gen(self, stmt->if_stmt.if_cond);
+			mn::print_to(self.out, ") ");
+			return stmt->if_stmt.if_body;
+		}
+		else if(step <= else_ifs.count)
 		{
+			const Else_If& e = else_ifs[step - 1];
 			mn::print_to(self.out, " else if (");
 			cgen_expr_gen(self, e.cond);
 			mn::print_to(self.out, ") ");
-			cgen_stmt_gen(self, e.body);
+			return e.body;
 		}
-
-		if(stmt->if_stmt.else_body)
+		else if(step == else_ifs.count + 1 && stmt->if_stmt.else_body)
 		{
 			mn::print_to(self.out, " else ");
-			cgen_stmt_gen(self, stmt->if_stmt.else_body);
+			return stmt->if_stmt.else_body;
 		}
+		return nullptr;
 	}
 
-	inline static void
-	cgen_stmt_for(CGen& self, Stmt* stmt)
+	//the children come in the order of stmt_child so the one done last tells how far the for stmt got
+	inline static Stmt*
+	cgen_stmt_for_visit(CGen& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_FOR);
+		const auto& for_stmt = stmt->for_stmt;
+		Stmt* done = step > 0 ? stmt_child(stmt, step - 1) : nullptr;
 
-		cgen_scope_enter(self, src_scope_of(self.src, stmt));
-
-		mn::print_to(self.out, "for (");
-		if (stmt->for_stmt.init_stmt)
+		if(step == 0)
 		{
-			cgen_stmt_gen(self, stmt->for_stmt.init_stmt);
-			mn::print_to(self.out, "; ");
-		}
-		else
-		{
-			mn::print_to(self.out, ";");
+			cgen_scope_enter(self, src_scope_of(self.src, stmt));
+			mn::print_to(self.out, "for (");
+			if (for_stmt.init_stmt)
+				return for_stmt.init_stmt;
 		}
 
-		if (stmt->for_stmt.loop_cond)
-		{
-			cgen_expr_gen(self, stmt->for_stmt.loop_cond);
-			mn::print_to(self.out, "; ");
-		}
-		else
+		if(done == for_stmt.init_stmt)
 		{
-			mn::print_to(self.out, ";");
-		}
+			if (for_stmt.init_stmt)
+				mn::print_to(self.out, "; ");
+			else
+				mn::print_to(self.out, ";");
 
-		if (stmt->for_stmt.post_stmt)
-			cgen_stmt_gen(self, stmt->for_stmt.post_stmt);
+			if (for_stmt.loop_cond)
+			{
+				cgen_expr_gen(self, for_stmt.loop_cond);
+				mn::print_to(self.out, "; ");
+			}
+			else
+			{
+				mn::print_to(self.out, ";");
+			}
 
-		mn::print_to(self.out, ") ");
+			if (for_stmt.post_stmt)
+				return for_stmt.post_stmt;
+		}
 
-		cgen_stmt_gen(self, stmt->for_stmt.loop_body);
+		if(done != for_stmt.loop_body)
+		{
+			mn::print_to(self.out, ") ");
+			return for_stmt.loop_body;
+		}
 
 		cgen_scope_leave(self);
+		return nullptr;
 	}
 
 	inline static void
@@ -660,104 +722,112 @@ namespace zay
 		}
 	}
 
+	//the simple stmts end with a semicolon in a block
 	inline static void
-	cgen_stmt_anonymous_block_gen(CGen& self, Stmt* stmt)
+	cgen_stmt_end(CGen& self, Stmt* s)
 	{
-		assert(stmt->kind == Stmt::KIND_BLOCK);
-
-		cgen_scope_enter(self, src_scope_of(self.src, stmt));
-
-		mn::print_to(self.out, "{{");
-
-		self.indent++;
-
-		for (Stmt* s : stmt->block_stmt)
+		if (s->kind == Stmt::KIND_ASSIGN ||
+			s->kind == Stmt::KIND_BREAK ||
+			s->kind == Stmt::KIND_CONTINUE ||
+			s->kind == Stmt::KIND_RETURN ||
+			s->kind == Stmt::KIND_VAR)
 		{
-			cgen_newline(self);
-			cgen_stmt_gen(self, s);
-			if (s->kind == Stmt::KIND_ASSIGN ||
-				s->kind == Stmt::KIND_BREAK ||
-				s->kind == Stmt::KIND_CONTINUE ||
-				s->kind == Stmt::KIND_RETURN ||
-				s->kind == Stmt::KIND_VAR)
-			{
-				mn::print_to(self.out, ";");
-			}
+			mn::print_to(self.out, ";");
 		}
-
-		self.indent--;
-		cgen_newline(self);
-
-		mn::print_to(self.out, "}}");
-
-		cgen_scope_leave(self);
 	}
 
-	inline static void
-	cgen_stmt_block_gen(CGen& self, Stmt* stmt)
+	inline static Stmt*
+	cgen_stmt_anonymous_block_visit(CGen& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_BLOCK);
 
-		mn::print_to(self.out, "{{");
-
-		self.indent++;
+		if(step == 0)
+		{
+			cgen_scope_enter(self, src_scope_of(self.src, stmt));
+			mn::print_to(self.out, "{{");
+			self.indent++;
+		}
+		else
+		{
+			cgen_stmt_end(self, stmt->block_stmt[step - 1]);
+		}
 
-		for(Stmt* s: stmt->block_stmt)
+		if(step < stmt->block_stmt.count)
 		{
 			cgen_newline(self);
-			cgen_stmt_gen(self, s);
-			if (s->kind == Stmt::KIND_ASSIGN ||
-				s->kind == Stmt::KIND_BREAK ||
-				s->kind == Stmt::KIND_CONTINUE ||
-				s->kind == Stmt::KIND_RETURN ||
-				s->kind == Stmt::KIND_VAR)
-			{
-				mn::print_to(self.out, ";");
-			}
+			return stmt->block_stmt[step];
 		}
 
 		self.indent--;
 		cgen_newline(self);
 
 		mn::print_to(self.out, "}}");
+
+		cgen_scope_leave(self);
+		return nullptr;
 	}
 
-	inline static void
-	cgen_stmt_gen(CGen& self, Stmt* stmt)
+	inline static Stmt*
+	cgen_stmt_visit(CGen& self, Stmt* stmt, size_t step)
 	{
 		switch(stmt->kind)
 		{
 		case Stmt::KIND_BREAK:
 			mn::print_to(self.out, "break");
-			break;
+			return nullptr;
 		case Stmt::KIND_CONTINUE:
 			mn::print_to(self.out, "continue");
-			break;
+			return nullptr;
 		case Stmt::KIND_RETURN:
 			cgen_stmt_return(self, stmt);
-			break;
+			return nullptr;
 		case Stmt::KIND_IF:
-			cgen_stmt_if(self, stmt);
-			break;
+			return cgen_stmt_if_visit(self, stmt, step);
 		case Stmt::KIND_FOR:
-			cgen_stmt_for(self, stmt);
-			break;
+			return cgen_stmt_for_visit(self, stmt, step);
 		case Stmt::KIND_VAR:
 			cgen_stmt_var(self, stmt);
-			break;
+			return nullptr;
 		case Stmt::KIND_ASSIGN:
 			cgen_stmt_assign_gen(self, stmt);
-			break;
+			return nullptr;
 		case Stmt::KIND_EXPR:
 			cgen_expr_gen(self, stmt->expr_stmt);
-			break;
+			return nullptr;
 		case Stmt::KIND_BLOCK:
-			cgen_stmt_anonymous_block_gen(self, stmt);
-			break;
+			return cgen_stmt_anonymous_block_visit(self, stmt, step);
 		default:
 			assert(false && "unreachable");
-			break;
+			return nullptr;
+		}
+	}
+
+	inline static void
+	cgen_stmt_gen(CGen& self, Stmt* stmt)
+	{
+		stmt_walk(self.stmt_stack, stmt, self, cgen_stmt_visit);
+	}
+
+	inline static void
+	cgen_stmt_block_gen(CGen& self, Stmt* stmt)
+	{
+		assert(stmt->kind == Stmt::KIND_BLOCK);
+
+		mn::print_to(self.out, "{{");
+
+		self.indent++;
+
+		for(Stmt* s: stmt->block_stmt)
+		{
+			cgen_newline(self);
+			cgen_stmt_gen(self, s);
+			cgen_stmt_end(self, s);
 		}
+
+		self.indent--;
+		cgen_newline(self);
+
+		mn::print_to(self.out, "}}");
 	}
 
 
@@ -861,6 +931,8 @@ namespace zay
 		self.src = src;
 		self.out = mn::memory_stream_new();
 		self.scope_stack = mn::buf_new<Scope*>();
+		self.expr_stack = mn::buf_new<Expr_Walk_Frame>();
+		self.stmt_stack = mn::buf_new<Stmt_Walk_Frame>();
 
 		mn::buf_push(self.scope_stack, src_scope_of(src, nullptr));
 		return self;
@@ -871,6 +943,8 @@ namespace zay
 	{
 		mn::stream_free(self.out);
 		mn::buf_free(self.scope_stack);
+		mn::buf_free(self.expr_stack);
+		mn::buf_free(self.stmt_stack);
 	}
 
 	void
@@ -0,0 +1,93 @@
+#include "zay/File_Map.h"
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace zay
+{
+	inline static mn::Str
+	view_new(void* ptr, size_t size)
+	{
+		mn::Str self{};
+		self.ptr = (char*)ptr;
+		self.count = size;
+		return self;
+	}
+
+#if defined(_WIN32)
+	mn::Str
+	file_map(const char* path)
+	{
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(file == INVALID_HANDLE_VALUE)
+			return mn::Str{};
+
+		LARGE_INTEGER size{};
+		if(GetFileSizeEx(file, &size) == FALSE || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return mn::Str{};
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		//the view keeps the mapping alive so we don't need the handles anymore
+		CloseHandle(file);
+		if(mapping == NULL)
+			return mn::Str{};
+
+		void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if(ptr == NULL)
+			return mn::Str{};
+
+		return view_new(ptr, size_t(size.QuadPart));
+	}
+
+	void
+	file_unmap(mn::Str& view)
+	{
+		if(view.ptr)
+			UnmapViewOfFile(view.ptr);
+		view = mn::Str{};
+	}
+#else
+	mn::Str
+	file_map(const char* path)
+	{
+		int file = ::open(path, O_RDONLY);
+		if(file == -1)
+			return mn::Str{};
+
+		struct stat info{};
+		if(::fstat(file, &info) == -1 || info.st_size == 0)
+		{
+			::close(file);
+			return mn::Str{};
+		}
+
+		void* ptr = ::mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		//the mapping stays valid after closing the file
+		::close(file);
+		if(ptr == MAP_FAILED)
+			return mn::Str{};
+
+		return view_new(ptr, size_t(info.st_size));
+	}
+
+	void
+	file_unmap(mn::Str& view)
+	{
+		if(view.ptr)
+			::munmap(view.ptr, view.count);
+		view = mn::Str{};
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "zay/Intern.h"
+
+#include <mn/Memory.h>
+
+namespace zay
+{
+	// strings bigger than a quarter of this get their own page
+	constexpr size_t INTERN_PAGE_SIZE = 64 * 1024;
+	constexpr size_t INTERN_TABLE_MIN_COUNT = 64;
+
+	inline static uint64_t
+	hash_mix(uint64_t x)
+	{
+		x ^= x >> 32;
+		x *= 0xD6E8FEB86659FD93ULL;
+		x ^= x >> 32;
+		return x;
+	}
+
+	inline static uint64_t
+	load_u64(const char* it)
+	{
+		uint64_t res = 0;
+		::memcpy(&res, it, sizeof(res));
+		return res;
+	}
+
+	inline static char*
+	shard_alloc(Intern_Shard& self, size_t size)
+	{
+		if(size_t(self.page_end - self.page_it) < size)
+		{
+			size_t page_size = size > INTERN_PAGE_SIZE / 4 ? size : INTERN_PAGE_SIZE;
+			auto page = mn::alloc_from(mn::memory::clib(), page_size, alignof(uint64_t));
+			mn::buf_push(self.pages, page);
+			//big strings don't replace the current page since it's probably not full yet
+			if(page_size != INTERN_PAGE_SIZE)
+				return (char*)page.ptr;
+			self.page_it = (char*)page.ptr;
+			self.page_end = self.page_it + page_size;
+		}
+		char* res = self.page_it;
+		self.page_it += size;
+		return res;
+	}
+
+	inline static void
+	shard_grow(Intern_Shard& self)
+	{
+		auto table = mn::buf_with_allocator<Intern_Entry>(mn::memory::clib());
+		mn::buf_resize_fill(table, self.table.count * 2, Intern_Entry{});
+		size_t mask = table.count - 1;
+		for(const Intern_Entry& e: self.table)
+		{
+			if(e.str == nullptr)
+				continue;
+			size_t ix = size_t(e.hash) & mask;
+			while(table[ix].str != nullptr)
+				ix = (ix + 1) & mask;
+			table[ix] = e;
+		}
+		mn::buf_free(self.table);
+		self.table = table;
+	}
+
+	// frees the global pool when the process exits
+	struct Global_Intern_Pool
+	{
+		Intern_Pool* pool;
+
+		Global_Intern_Pool() { pool = intern_pool_new(); }
+		~Global_Intern_Pool() { intern_pool_free(pool); }
+	};
+
+
+	//API
+	Intern_Pool*
+	intern_pool_new()
+	{
+		auto self = mn::alloc_zerod_from<Intern_Pool>(mn::memory::clib());
+		for(Intern_Shard& shard: self->shards)
+		{
+			shard.mtx = mn::mutex_new("zay intern shard");
+			shard.table = mn::buf_with_allocator<Intern_Entry>(mn::memory::clib());
+			mn::buf_resize_fill(shard.table, INTERN_TABLE_MIN_COUNT, Intern_Entry{});
+			shard.pages = mn::buf_with_allocator<mn::Block>(mn::memory::clib());
+		}
+		return self;
+	}
+
+	void
+	intern_pool_free(Intern_Pool* self)
+	{
+		for(Intern_Shard& shard: self->shards)
+		{
+			mn::mutex_free(shard.mtx);
+			mn::buf_free(shard.table);
+			for(mn::Block page: shard.pages)
+				mn::free_from(mn::memory::clib(), page);
+			mn::buf_free(shard.pages);
+		}
+		mn::free_from(mn::memory::clib(), self);
+	}
+
+	Intern_Pool*
+	intern_pool_global()
+	{
+		//function statics are initialized once even if many threads get here at the same time
+		static Global_Intern_Pool global;
+		return global.pool;
+	}
+
+	uint64_t
+	intern_hash(const char* begin, const char* end)
+	{
+		//8 bytes at a time, the tail is loaded as one overlapping word
+		size_t len = size_t(end - begin);
+		uint64_t h = 0x9E3779B97F4A7C15ULL ^ len;
+		const char* it = begin;
+		for(; size_t(end - it) >= 8; it += 8)
+			h = hash_mix(h ^ load_u64(it)) * 0xBF58476D1CE4E5B9ULL;
+		if(len >= 8 && it != end)
+		{
+			h = hash_mix(h ^ load_u64(end - 8)) * 0xBF58476D1CE4E5B9ULL;
+		}
+		else if(it != end)
+		{
+			uint64_t tail = 0;
+			::memcpy(&tail, it, size_t(end - it));
+			h = hash_mix(h ^ tail) * 0xBF58476D1CE4E5B9ULL;
+		}
+		return hash_mix(h);
+	}
+
+	const char*
+	intern_pool_get(Intern_Pool* self, const char* begin, const char* end)
+	{
+		uint64_t hash = intern_hash(begin, end);
+		size_t len = size_t(end - begin);
+		//the high bits pick the shard and the low bits pick the slot so they don't correlate
+		Intern_Shard& shard = self->shards[hash >> 58 & (INTERN_SHARDS_COUNT - 1)];
+
+		mn::mutex_lock(shard.mtx);
+		size_t mask = shard.table.count - 1;
+		size_t ix = size_t(hash) & mask;
+		while(shard.table[ix].str != nullptr)
+		{
+			const Intern_Entry& e = shard.table[ix];
+			if(e.hash == hash && e.len == len && (len == 0 || ::memcmp(e.str, begin, len) == 0))
+			{
+				mn::mutex_unlock(shard.mtx);
+				return e.str;
+			}
+			ix = (ix + 1) & mask;
+		}
+
+		//the hash goes right before the string so it travels with the interned pointer, the size is
+		//rounded up to keep the next hash aligned
+		size_t size = (sizeof(uint64_t) + len + 1 + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1);
+		char* mem = shard_alloc(shard, size);
+		::memcpy(mem, &hash, sizeof(hash));
+		char* str = mem + sizeof(uint64_t);
+		if(len > 0)
+			::memcpy(str, begin, len);
+		str[len] = '\0';
+		shard.table[ix] = Intern_Entry{hash, str, len};
+		++shard.count;
+		//keep the load under 3/4 so probes stay short
+		if(shard.count * 4 > shard.table.count * 3)
+			shard_grow(shard);
+		mn::mutex_unlock(shard.mtx);
+		return str;
+	}
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "zay/Src.h"
 #include "zay/parse/AST_Lisp.h"
+#include "zay/scan/Simd.h"
+#include "zay/File_Map.h"
 
 #include <mn/Memory.h>
 #include <mn/File.h>
@@ -8,18 +10,23 @@
 #include <mn/IO.h>
 #include <mn/Defer.h>
 
+#include <string.h>
+
 namespace zay
 {
-	Src*
-	src_from_file(const char* path)
+	inline static Src*
+	src_new(const mn::Str& path, const mn::Str& content, CONTENT content_kind)
 	{
 		auto self = mn::alloc<Src>();
-		self->path = mn::str_from_c(path);
-		self->content = mn::file_content_str(path);
+		self->path = path;
+		self->content = content;
+		self->content_kind = content_kind;
 		self->lines = mn::buf_new<Line>();
-		self->str_table = mn::str_intern_new();
+		self->str_table = intern_pool_global();
 		self->errs = mn::buf_new<Err>();
-		self->tkns = mn::buf_new<Tkn>();
+		self->tkns = tkn_store_new();
+		self->comments = COMMENTS::TOKENS;
+		self->bodies = BODIES::EAGER;
 		self->ast = ast_new();
 		self->scopes = mn::buf_new<Scope*>();
 		self->scope_table = mn::map_new<void*, Scope*>();
@@ -28,33 +35,57 @@ namespace zay
 		return self;
 	}
 
+	inline static void
+	src_content_free(Src *self)
+	{
+		switch(self->content_kind)
+		{
+		case CONTENT::OWNED:
+			mn::str_free(self->content);
+			break;
+		case CONTENT::MAPPED:
+			file_unmap(self->content);
+			break;
+		case CONTENT::BORROWED:
+		default:
+			//the caller owns it
+			break;
+		}
+	}
+
+	Src*
+	src_from_file(const char* path)
+	{
+		//map the file if we can to avoid copying it, empty files can't be mapped so read them instead
+		auto content = file_map(path);
+		if(content.count > 0)
+			return src_new(mn::str_from_c(path), content, CONTENT::MAPPED);
+		return src_new(mn::str_from_c(path), mn::file_content_str(path), CONTENT::OWNED);
+	}
+
 	Src*
 	src_from_str(const char* code)
 	{
-		auto self = mn::alloc<Src>();
-		self->path = mn::str_from_c("<STRING>");
-		self->content = mn::str_from_c(code);
-		self->lines = mn::buf_new<Line>();
-		self->str_table = mn::str_intern_new();
-		self->errs = mn::buf_new<Err>();
-		self->tkns = mn::buf_new<Tkn>();
-		self->ast = ast_new();
-		self->scopes = mn::buf_new<Scope*>();
-		self->scope_table = mn::map_new<void*, Scope*>();
-		self->type_table = type_intern_new();
-		self->reachable_syms = mn::buf_new<Sym*>();
-		return self;
+		return src_new(mn::str_from_c("<STRING>"), mn::str_from_c(code), CONTENT::OWNED);
+	}
+
+	Src*
+	src_from_buffer(const char* code, size_t size)
+	{
+		mn::Str content{};
+		content.ptr = (char*)code;
+		content.count = size;
+		return src_new(mn::str_from_c("<STRING>"), content, CONTENT::BORROWED);
 	}
 
 	void
 	src_free(Src *self)
 	{
 		mn::str_free(self->path);
-		mn::str_free(self->content);
+		src_content_free(self);
 		mn::buf_free(self->lines);
-		mn::str_intern_free(self->str_table);
 		destruct(self->errs);
-		mn::buf_free(self->tkns);
+		tkn_store_free(self->tkns);
 		ast_free(self->ast);
 		destruct(self->scopes);
 		mn::map_free(self->scope_table);
@@ -63,6 +94,151 @@ namespace zay
 		mn::free(self);
 	}
 
+	void
+	src_content_replace(Src *self, size_t begin_offset, size_t end_offset, const char* text, size_t text_count)
+	{
+		//we can only edit our own copy of the content
+		if(self->content_kind != CONTENT::OWNED)
+		{
+			auto content = mn::str_from_substr(begin(self->content), end(self->content));
+			src_content_free(self);
+			self->content = content;
+			self->content_kind = CONTENT::OWNED;
+		}
+
+		size_t tail_count = self->content.count - end_offset;
+		size_t count = begin_offset + text_count + tail_count;
+		if(count > self->content.count)
+			mn::str_resize(self->content, count);
+		if(tail_count > 0)
+			::memmove(self->content.ptr + begin_offset + text_count, self->content.ptr + end_offset, tail_count);
+		if(text_count > 0)
+			::memcpy(self->content.ptr + begin_offset, text, text_count);
+		mn::str_resize(self->content, count);
+
+		//the lines point into the old content
+		mn::buf_clear(self->lines);
+	}
+
+	const mn::Buf<Line>&
+	src_lines(Src *self)
+	{
+		if(self->lines.count > 0)
+			return self->lines;
+
+		const char* it = begin(self->content);
+		const char* end_it = end(self->content);
+		mn::buf_reserve(self->lines, count_byte(it, end_it, '\n') + 1);
+		while(true)
+		{
+			const char* newline_it = find_byte(it, end_it, '\n');
+			mn::buf_push(self->lines, Line{it, newline_it});
+			if(newline_it == end_it)
+				break;
+			it = newline_it + 1;
+		}
+		return self->lines;
+	}
+
+	Pos
+	src_pos(Src *self, const char* it)
+	{
+		const auto& lines = src_lines(self);
+
+		//binary search for the last line which begins at or before it
+		size_t first = 0;
+		size_t last = lines.count;
+		while(last - first > 1)
+		{
+			size_t mid = first + (last - first) / 2;
+			if(lines[mid].begin <= it)
+				first = mid;
+			else
+				last = mid;
+		}
+
+		//the scanner counts the columns of the first line from 0 and the rest from 1
+		Pos res{};
+		res.line = uint32_t(first + 1);
+		res.col = first == 0 ? 0 : 1;
+		for(const char* col_it = lines[first].begin; col_it < it; ++col_it)
+		{
+			//only count the first byte of each rune
+			if((uint8_t(*col_it) & 0xC0) != 0x80)
+				res.col++;
+		}
+		return res;
+	}
+
+	Pos
+	pos_advance(Pos pos, const char* from, const char* it)
+	{
+		//every new line resets the column so only the last line's runes are counted
+		size_t lines_count = count_byte(from, it, '\n');
+		if(lines_count > 0)
+		{
+			pos.line += uint32_t(lines_count);
+			pos.col = 1;
+			from = it;
+			while(from[-1] != '\n')
+				--from;
+		}
+
+		for(; from < it; ++from)
+		{
+			//only count the first byte of each rune
+			if((uint8_t(*from) & 0xC0) != 0x80)
+				pos.col++;
+		}
+		return pos;
+	}
+
+	Tkn
+	src_tkn_at(Src *self, size_t ix)
+	{
+		return src_tkn_at(self, ix, src_pos(self, begin(self->content) + self->tkns.offsets[ix]));
+	}
+
+	Tkn
+	src_tkn_at(Src *self, size_t ix, Pos pos)
+	{
+		Tkn res{};
+		res.kind = Tkn::KIND(self->tkns.kinds[ix]);
+		res.rng.begin = begin(self->content) + self->tkns.offsets[ix];
+		res.rng.end = res.rng.begin + self->tkns.lens[ix];
+		res.pos = pos;
+
+		//the literal values were decoded by the scanner, they're in Tkn_Store::values
+		switch(res.kind)
+		{
+		case Tkn::KIND_ID:
+		case Tkn::KIND_INTEGER:
+		case Tkn::KIND_FLOAT:
+		case Tkn::KIND_STRING:
+			res.str = intern_pool_get(self->str_table, res.rng.begin, res.rng.end);
+			break;
+		case Tkn::KIND_COMMENT:
+		{
+			//same as the scanner, skip the // and stop one char before the \n
+			const char* text_begin = res.rng.begin + 2;
+			const char* text_end = res.rng.end;
+			if(text_end > text_begin && text_end[-1] == '\n')
+			{
+				--text_end;
+				if(text_end > text_begin)
+					--text_end;
+			}
+			res.str = intern_pool_get(self->str_table, text_begin, text_end);
+			break;
+		}
+		default:
+			//keywords and operators have a fixed spelling
+			res.str = Tkn::NAMES[res.kind];
+			break;
+		}
+		return res;
+	}
+
 	mn::Str
 	src_errs_dump(Src *self, mn::Allocator allocator)
 	{
@@ -72,7 +248,7 @@ namespace zay
 		{
 			if(e.pos.line > 0)
 			{
-				Line l = self->lines[e.pos.line - 1];
+				Line l = src_lines(self)[e.pos.line - 1];
 				//we need to put ^^^ under the word the compiler means by the error
 				if(e.rng.begin && e.rng.end)
 				{
@@ -112,8 +288,14 @@ namespace zay
 		//this is a tmp stream you can use to construct strings into
 		auto out = mn::memory_stream_new(allocator);
 		mn_defer(mn::memory_stream_free(out));
-		for(const Tkn& t: self->tkns)
+		const char* it = begin(self->content);
+		Pos pos{1, 0};
+		for(size_t i = 0; i < tkn_store_count(self->tkns); ++i)
 		{
+			const char* tkn_it = begin(self->content) + self->tkns.offsets[i];
+			pos = pos_advance(pos, it, tkn_it);
+			it = tkn_it;
+			Tkn t = src_tkn_at(self, i, pos);
 			mn::print_to(
 				out,
 				"line: {}, col: {}, kind: \"{}\" str: \"{}\"\n",
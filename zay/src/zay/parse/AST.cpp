@@ -1,4 +1,5 @@
 #include "zay/parse/AST.h"
+#include "zay/Intern.h"
 #include "zay/typecheck/Type_Intern.h"
 
 #include <mn/Memory.h>
@@ -7,18 +8,79 @@
 
 namespace zay
 {
+	constexpr size_t AST_TYPENAMES_MIN_COUNT = 16;
+
+	inline static size_t
+	ast_typename_slot(const mn::Buf<const char*>& set, const char* name)
+	{
+		size_t mask = set.count - 1;
+		size_t ix = size_t(intern_hash_of(name)) & mask;
+		//interned names are the same pointer so no string compare is needed
+		while(set[ix] != nullptr && set[ix] != name)
+			ix = (ix + 1) & mask;
+		return ix;
+	}
+
+
+	//API
 	AST
 	ast_new()
 	{
 		AST self{};
 		self.package = Tkn{};
 		self.decls = mn::buf_new<Decl*>();
+		self.arena = mn::allocator_arena_new(AST_ARENA_BLOCK_SIZE);
+		self.slice_arenas = mn::buf_new<mn::Allocator>();
+		self.typenames = mn::buf_new<Tkn>();
+		self.typenames_set = mn::buf_new<const char*>();
+		self.signs = type_sign_table_new();
 		return self;
 	}
 
 	void
 	ast_free(AST &self)
 	{
-		destruct(self.decls);
+		//the decls are in the arena so there's no need to walk them
+		mn::buf_free(self.decls);
+		mn::buf_free(self.typenames);
+		mn::buf_free(self.typenames_set);
+		type_sign_table_free(self.signs);
+		mn::allocator_free(self.arena);
+		for(mn::Allocator arena: self.slice_arenas)
+			mn::allocator_free(arena);
+		mn::buf_free(self.slice_arenas);
+	}
+
+	void
+	ast_typename_add(AST &self, const Tkn& tkn)
+	{
+		//only ids are interned, anything else is a syntax error the parser reports later
+		if(tkn.kind != Tkn::KIND_ID)
+			return;
+
+		mn::buf_push(self.typenames, tkn);
+
+		//keep the load under 1/2, the typenames buf is an upper bound of the set count
+		if(self.typenames.count * 2 > self.typenames_set.count)
+		{
+			size_t count = self.typenames_set.count == 0 ? AST_TYPENAMES_MIN_COUNT : self.typenames_set.count * 2;
+			auto set = mn::buf_with_allocator<const char*>(self.typenames_set.allocator);
+			mn::buf_resize_fill(set, count, (const char*)nullptr);
+			for(const char* name: self.typenames_set)
+				if(name)
+					set[ast_typename_slot(set, name)] = name;
+			mn::buf_free(self.typenames_set);
+			self.typenames_set = set;
+		}
+
+		self.typenames_set[ast_typename_slot(self.typenames_set, tkn.str)] = tkn.str;
+	}
+
+	bool
+	ast_typename_has(const AST &self, const char* name)
+	{
+		if(self.typenames_set.count == 0)
+			return false;
+		return self.typenames_set[ast_typename_slot(self.typenames_set, name)] != nullptr;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,1188 @@
+#include "zay/parse/AST_Cache.h"
+#include "zay/parse/Parser.h"
+#include "zay/Intern.h"
+#include "zay/File_Map.h"
+
+#include <mn/Memory.h>
+#include <mn/Map.h>
+#include <mn/File.h>
+#include <mn/Path.h>
+#include <mn/Defer.h>
+
+#include <assert.h>
+#include <string.h>
+
+namespace zay
+{
+	constexpr char AST_CACHE_MAGIC[4] = {'Z', 'A', 'S', 'T'};
+
+	// the missing string or source offset
+	constexpr uint32_t AST_CACHE_NIL = UINT32_MAX;
+
+	// the str of keywords and operators which is their spelling in Tkn::NAMES
+	constexpr uint32_t AST_CACHE_NAME = UINT32_MAX - 1;
+
+	// the blob begins with the header, then the string table where every string is its byte count followed
+	// by its bytes, then the nodes in pre-order where every node is its kind followed by its fields, the
+	// children of an expr follow its fields in the order of expr_child and end with a KIND_NONE
+	struct AST_Cache_Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t mode;
+		uint32_t bodies;
+		uint32_t strs_count;
+		uint64_t content_hash;
+		uint64_t content_count;
+		// byte count of the whole blob, a cache file cut short doesn't match it
+		uint64_t size;
+	};
+
+	struct AST_Cache_Str
+	{
+		const char* ptr;
+		uint32_t count;
+	};
+
+	struct AST_Cache_Writer
+	{
+		Src* src;
+		mn::Buf<uint8_t> nodes;
+		mn::Buf<AST_Cache_Str> strs;
+		// index of every interned string in strs
+		mn::Map<const char*, uint32_t> strs_index;
+		// the exprs are walked with an explicit stack so deep exprs don't overflow the call stack
+		mn::Buf<Expr_Walk_Frame> exprs_stack;
+	};
+
+	struct AST_Cache_Reader
+	{
+		Src* src;
+		const uint8_t* it;
+		const uint8_t* end;
+		// the interned strings of the string table
+		mn::Buf<const char*> strs;
+		// the exprs are rebuilt with an explicit stack so deep exprs don't overflow the call stack
+		mn::Buf<Expr_Walk_Frame> exprs_stack;
+		// we read past the end or found a value which no encoder writes, every read after it returns zeros
+		bool failed;
+	};
+
+	// ids and literals have interned strs, everything else uses its spelling
+	inline static bool
+	cache_tkn_interned(Tkn::KIND kind)
+	{
+		return (kind == Tkn::KIND_ID ||
+				kind == Tkn::KIND_INTEGER ||
+				kind == Tkn::KIND_FLOAT ||
+				kind == Tkn::KIND_STRING ||
+				kind == Tkn::KIND_COMMENT);
+	}
+
+	inline static uint64_t
+	cache_content_hash(Src* src)
+	{
+		return intern_hash(begin(src->content), end(src->content));
+	}
+
+	//writer
+	inline static void
+	cache_write(mn::Buf<uint8_t>& out, const void* ptr, size_t size)
+	{
+		size_t count = out.count;
+		mn::buf_resize(out, count + size);
+		::memcpy(out.ptr + count, ptr, size);
+	}
+
+	inline static void
+	cache_u8(AST_Cache_Writer& self, uint8_t value)
+	{
+		mn::buf_push(self.nodes, value);
+	}
+
+	inline static void
+	cache_u32(AST_Cache_Writer& self, uint32_t value)
+	{
+		cache_write(self.nodes, &value, sizeof(value));
+	}
+
+	inline static void
+	cache_u64(AST_Cache_Writer& self, uint64_t value)
+	{
+		cache_write(self.nodes, &value, sizeof(value));
+	}
+
+	inline static uint32_t
+	cache_str(AST_Cache_Writer& self, const char* str, size_t count)
+	{
+		if(str == nullptr)
+			return AST_CACHE_NIL;
+
+		if(auto it = mn::map_lookup(self.strs_index, str))
+			return it->value;
+
+		uint32_t ix = uint32_t(self.strs.count);
+		mn::buf_push(self.strs, AST_Cache_Str{str, uint32_t(count)});
+		mn::map_insert(self.strs_index, str, ix);
+		return ix;
+	}
+
+	inline static void
+	cache_offset(AST_Cache_Writer& self, const char* it)
+	{
+		if(it == nullptr)
+			cache_u32(self, AST_CACHE_NIL);
+		else
+			cache_u32(self, uint32_t(it - begin(self.src->content)));
+	}
+
+	inline static void
+	cache_rng_pos(AST_Cache_Writer& self, const Rng& rng, const Pos& pos)
+	{
+		cache_offset(self, rng.begin);
+		cache_offset(self, rng.end);
+		cache_u32(self, pos.line);
+		cache_u32(self, pos.col);
+	}
+
+	inline static void
+	cache_tkn(AST_Cache_Writer& self, const Tkn& tkn)
+	{
+		cache_u8(self, uint8_t(tkn.kind));
+		if(tkn == false)
+			return;
+
+		cache_rng_pos(self, tkn.rng, tkn.pos);
+
+		if(tkn.str == nullptr)
+		{
+			cache_u32(self, AST_CACHE_NIL);
+		}
+		else if(cache_tkn_interned(tkn.kind) == false)
+		{
+			assert(tkn.str == Tkn::NAMES[tkn.kind]);
+			cache_u32(self, AST_CACHE_NAME);
+		}
+		else if(tkn.kind == Tkn::KIND_STRING)
+		{
+			//the raw string may contain '\0' so it can't be strlen'ed, it's the whole token
+			cache_u32(self, cache_str(self, tkn.str, size_t(tkn.rng.end - tkn.rng.begin)));
+		}
+		else
+		{
+			cache_u32(self, cache_str(self, tkn.str, ::strlen(tkn.str)));
+		}
+	}
+
+	// the literal values aren't in the tokens so they're cached on their own, the string values are in
+	// the string table and the rest are written as their bits
+	inline static void
+	cache_values(AST_Cache_Writer& self, const mn::Buf<Tkn_Value>& values)
+	{
+		cache_u32(self, uint32_t(values.count));
+		for(const Tkn_Value& value: values)
+		{
+			cache_u32(self, value.offset);
+			cache_u32(self, value.count);
+			//only string literals begin with a "
+			if(self.src->content.ptr[value.offset] == '"')
+			{
+				cache_u8(self, 1);
+				cache_u64(self, cache_str(self, value.string, value.count));
+			}
+			else
+			{
+				cache_u8(self, 0);
+				cache_u64(self, value.integer);
+			}
+		}
+	}
+
+	inline static void
+	cache_tkns(AST_Cache_Writer& self, const mn::Buf<Tkn>& tkns)
+	{
+		cache_u32(self, uint32_t(tkns.count));
+		for(const Tkn& tkn: tkns)
+			cache_tkn(self, tkn);
+	}
+
+	inline static void
+	cache_tkns(AST_Cache_Writer& self, const Id_List& ids)
+	{
+		cache_u32(self, uint32_t(ids.count));
+		for(const Tkn& tkn: ids)
+			cache_tkn(self, tkn);
+	}
+
+	inline static void
+	cache_expr(AST_Cache_Writer& self, Expr* expr);
+
+	inline static void
+	cache_exprs(AST_Cache_Writer& self, const mn::Buf<Expr*>& exprs)
+	{
+		cache_u32(self, uint32_t(exprs.count));
+		for(Expr* expr: exprs)
+			cache_expr(self, expr);
+	}
+
+	inline static void
+	cache_type_sign(AST_Cache_Writer& self, const Type_Sign& sign);
+
+	inline static void
+	cache_fields(AST_Cache_Writer& self, const mn::Buf<Field>& fields)
+	{
+		cache_u32(self, uint32_t(fields.count));
+		for(const Field& field: fields)
+		{
+			cache_tkns(self, field.ids);
+			cache_type_sign(self, field.type);
+		}
+	}
+
+	inline static void
+	cache_type_sign(AST_Cache_Writer& self, const Type_Sign& sign)
+	{
+		cache_u32(self, uint32_t(type_sign_count(sign)));
+		for(size_t i = 0; i < type_sign_count(sign); ++i)
+		{
+			const Type_Atom& atom = sign->atoms[i];
+			cache_u8(self, uint8_t(atom.kind));
+			switch(atom.kind)
+			{
+			case Type_Atom::KIND_NAMED:
+				cache_tkn(self, atom.named);
+				break;
+
+			case Type_Atom::KIND_PTR:
+				break;
+
+			case Type_Atom::KIND_ARRAY:
+				cache_tkn(self, atom.count);
+				break;
+
+			case Type_Atom::KIND_STRUCT:
+				cache_fields(self, atom.struct_fields);
+				break;
+
+			case Type_Atom::KIND_UNION:
+				cache_fields(self, atom.union_fields);
+				break;
+
+			case Type_Atom::KIND_ENUM:
+				cache_u32(self, uint32_t(atom.enum_fields.count));
+				for(const Enum_Field& field: atom.enum_fields)
+				{
+					cache_tkn(self, field.id);
+					cache_expr(self, field.expr);
+				}
+				break;
+
+			case Type_Atom::KIND_FUNC:
+				cache_u32(self, uint32_t(atom.func.args.count));
+				for(const Type_Sign& arg: atom.func.args)
+					cache_type_sign(self, arg);
+				cache_type_sign(self, atom.func.ret);
+				break;
+
+			default:
+				assert(false && "unreachable");
+				break;
+			}
+		}
+	}
+
+	inline static void
+	cache_var(AST_Cache_Writer& self, const Var& v)
+	{
+		cache_tkns(self, v.ids);
+		cache_type_sign(self, v.type);
+		cache_exprs(self, v.exprs);
+	}
+
+	// writes the kind, the range and the fields of the expr, the walk writes its children after them
+	inline static void
+	cache_expr_fields(AST_Cache_Writer& self, Expr* expr)
+	{
+		cache_u8(self, uint8_t(expr->kind));
+		cache_rng_pos(self, expr->rng, expr->pos);
+		switch(expr->kind)
+		{
+		case Expr::KIND_ATOM:
+			cache_tkn(self, expr->atom);
+			break;
+
+		case Expr::KIND_BINARY:
+			cache_tkn(self, expr->binary.op);
+			break;
+
+		case Expr::KIND_UNARY:
+			cache_tkn(self, expr->unary.op);
+			break;
+
+		case Expr::KIND_DOT:
+			cache_tkn(self, expr->dot.member);
+			break;
+
+		case Expr::KIND_INDEXED:
+		case Expr::KIND_PAREN:
+			break;
+
+		case Expr::KIND_CALL:
+			cache_u32(self, uint32_t(expr->call.args.count));
+			break;
+
+		case Expr::KIND_CAST:
+			cache_type_sign(self, expr->cast.type);
+			break;
+
+		case Expr::KIND_COMPLIT:
+			cache_type_sign(self, expr->complit.type);
+			cache_u32(self, uint32_t(expr->complit.fields.count));
+			for(const Complit_Field& field: expr->complit.fields)
+				cache_u8(self, uint8_t(field.kind));
+			break;
+
+		default:
+			assert(false && "unreachable");
+			break;
+		}
+	}
+
+	inline static Expr*
+	cache_expr_visit(AST_Cache_Writer& self, Expr* expr, size_t step)
+	{
+		if(step == 0)
+			cache_expr_fields(self, expr);
+
+		Expr* child = expr_child(expr, step);
+		if(child == nullptr)
+			cache_u8(self, Expr::KIND_NONE);
+		return child;
+	}
+
+	inline static void
+	cache_expr(AST_Cache_Writer& self, Expr* expr)
+	{
+		if(expr == nullptr)
+			cache_u8(self, Expr::KIND_NONE);
+		else
+			expr_walk(self.exprs_stack, expr, self, cache_expr_visit);
+	}
+
+	inline static void
+	cache_stmt(AST_Cache_Writer& self, Stmt* stmt)
+	{
+		if(stmt == nullptr)
+		{
+			cache_u8(self, Stmt::KIND_NONE);
+			return;
+		}
+
+		cache_u8(self, uint8_t(stmt->kind));
+		cache_rng_pos(self, stmt->rng, stmt->pos);
+		switch(stmt->kind)
+		{
+		case Stmt::KIND_BREAK:
+			cache_tkn(self, stmt->break_stmt);
+			break;
+
+		case Stmt::KIND_CONTINUE:
+			cache_tkn(self, stmt->continue_stmt);
+			break;
+
+		case Stmt::KIND_RETURN:
+			cache_expr(self, stmt->return_stmt);
+			break;
+
+		case Stmt::KIND_IF:
+			cache_expr(self, stmt->if_stmt.if_cond);
+			cache_stmt(self, stmt->if_stmt.if_body);
+			cache_u32(self, uint32_t(stmt->if_stmt.else_ifs.count));
+			for(const Else_If& else_if: stmt->if_stmt.else_ifs)
+			{
+				cache_expr(self, else_if.cond);
+				cache_stmt(self, else_if.body);
+			}
+			cache_stmt(self, stmt->if_stmt.else_body);
+			break;
+
+		case Stmt::KIND_FOR:
+			cache_stmt(self, stmt->for_stmt.init_stmt);
+			cache_expr(self, stmt->for_stmt.loop_cond);
+			cache_stmt(self, stmt->for_stmt.post_stmt);
+			cache_stmt(self, stmt->for_stmt.loop_body);
+			break;
+
+		case Stmt::KIND_VAR:
+			cache_var(self, stmt->var_stmt);
+			break;
+
+		case Stmt::KIND_ASSIGN:
+			cache_exprs(self, stmt->assign_stmt.lhs);
+			cache_tkn(self, stmt->assign_stmt.op);
+			cache_exprs(self, stmt->assign_stmt.rhs);
+			break;
+
+		case Stmt::KIND_EXPR:
+			cache_expr(self, stmt->expr_stmt);
+			break;
+
+		case Stmt::KIND_BLOCK:
+			cache_u32(self, uint32_t(stmt->block_stmt.count));
+			for(Stmt* s: stmt->block_stmt)
+				cache_stmt(self, s);
+			break;
+
+		default:
+			assert(false && "unreachable");
+			break;
+		}
+	}
+
+	inline static void
+	cache_decl(AST_Cache_Writer& self, Decl* decl)
+	{
+		cache_u8(self, uint8_t(decl->kind));
+		cache_tkn(self, decl->name);
+		cache_rng_pos(self, decl->rng, decl->pos);
+		switch(decl->kind)
+		{
+		case Decl::KIND_VAR:
+			cache_var(self, decl->var_decl);
+			break;
+
+		case Decl::KIND_FUNC:
+			cache_u32(self, uint32_t(decl->func_decl.args.count));
+			for(const Arg& arg: decl->func_decl.args)
+			{
+				cache_tkns(self, arg.ids);
+				cache_type_sign(self, arg.type);
+			}
+			cache_type_sign(self, decl->func_decl.ret_type);
+			//lazy bodies stay lazy, they're parsed from the content when the typer reaches them
+			cache_stmt(self, decl->func_decl.body);
+			cache_tkn(self, decl->func_decl.lazy_body_open);
+			break;
+
+		case Decl::KIND_TYPE:
+			cache_type_sign(self, decl->type_decl);
+			break;
+
+		default:
+			assert(false && "unreachable");
+			break;
+		}
+	}
+
+	//reader
+	inline static void
+	cache_read(AST_Cache_Reader& self, void* ptr, size_t size)
+	{
+		if(size_t(self.end - self.it) < size)
+		{
+			self.failed = true;
+			self.it = self.end;
+			::memset(ptr, 0, size);
+			return;
+		}
+		::memcpy(ptr, self.it, size);
+		self.it += size;
+	}
+
+	inline static void
+	cache_fail(AST_Cache_Reader& self)
+	{
+		self.failed = true;
+		self.it = self.end;
+	}
+
+	inline static uint8_t
+	cache_read_u8(AST_Cache_Reader& self)
+	{
+		uint8_t res = 0;
+		cache_read(self, &res, sizeof(res));
+		return res;
+	}
+
+	inline static uint32_t
+	cache_read_u32(AST_Cache_Reader& self)
+	{
+		uint32_t res = 0;
+		cache_read(self, &res, sizeof(res));
+		return res;
+	}
+
+	inline static uint64_t
+	cache_read_u64(AST_Cache_Reader& self)
+	{
+		uint64_t res = 0;
+		cache_read(self, &res, sizeof(res));
+		return res;
+	}
+
+	// every item takes at least 1 byte so a corrupted count can't make us loop beyond the end of the blob
+	inline static uint32_t
+	cache_read_count(AST_Cache_Reader& self)
+	{
+		uint32_t res = cache_read_u32(self);
+		if(res > size_t(self.end - self.it))
+		{
+			cache_fail(self);
+			return 0;
+		}
+		return res;
+	}
+
+	inline static uint8_t
+	cache_read_kind(AST_Cache_Reader& self, uint8_t last_kind)
+	{
+		uint8_t res = cache_read_u8(self);
+		if(res > last_kind)
+		{
+			cache_fail(self);
+			return 0;
+		}
+		return res;
+	}
+
+	inline static const char*
+	cache_read_str(AST_Cache_Reader& self, uint64_t ix)
+	{
+		if(ix == AST_CACHE_NIL)
+			return nullptr;
+
+		if(ix >= self.strs.count)
+		{
+			cache_fail(self);
+			return nullptr;
+		}
+		return self.strs[ix];
+	}
+
+	inline static const char*
+	cache_read_offset(AST_Cache_Reader& self)
+	{
+		uint32_t offset = cache_read_u32(self);
+		if(offset == AST_CACHE_NIL)
+			return nullptr;
+
+		if(offset > self.src->content.count)
+		{
+			cache_fail(self);
+			return nullptr;
+		}
+		return begin(self.src->content) + offset;
+	}
+
+	inline static void
+	cache_read_rng_pos(AST_Cache_Reader& self, Rng& rng, Pos& pos)
+	{
+		rng.begin = cache_read_offset(self);
+		rng.end = cache_read_offset(self);
+		pos.line = cache_read_u32(self);
+		pos.col = cache_read_u32(self);
+	}
+
+	inline static Tkn
+	cache_read_tkn(AST_Cache_Reader& self)
+	{
+		Tkn res{};
+		res.kind = Tkn::KIND(cache_read_kind(self, Tkn::KIND_KEYWORDS__END));
+		if(res == false)
+			return res;
+
+		cache_read_rng_pos(self, res.rng, res.pos);
+
+		uint32_t str = cache_read_u32(self);
+		if(str == AST_CACHE_NAME)
+		{
+			if(cache_tkn_interned(res.kind))
+				cache_fail(self);
+			else
+				res.str = Tkn::NAMES[res.kind];
+		}
+		else
+		{
+			res.str = cache_read_str(self, str);
+		}
+		return res;
+	}
+
+	inline static void
+	cache_read_values(AST_Cache_Reader& self, mn::Buf<Tkn_Value>& values)
+	{
+		uint32_t count = cache_read_count(self);
+		for(uint32_t i = 0; i < count && self.failed == false; ++i)
+		{
+			Tkn_Value value{};
+			value.offset = cache_read_u32(self);
+			value.count = cache_read_u32(self);
+			uint8_t is_string = cache_read_u8(self);
+			uint64_t bits = cache_read_u64(self);
+			if(value.offset >= self.src->content.count || is_string > 1)
+				cache_fail(self);
+			else if(is_string)
+				value.string = cache_read_str(self, bits);
+			else
+				value.integer = bits;
+			mn::buf_push(values, value);
+		}
+	}
+
+	inline static Id_List
+	cache_read_ids(AST_Cache_Reader& self)
+	{
+		auto res = small_buf_new<Id_List>();
+		uint32_t count = cache_read_count(self);
+		for(uint32_t i = 0; i < count; ++i)
+			small_buf_push(res, cache_read_tkn(self));
+		return res;
+	}
+
+	inline static Expr*
+	cache_read_expr(AST_Cache_Reader& self);
+
+	inline static mn::Buf<Expr*>
+	cache_read_exprs(AST_Cache_Reader& self)
+	{
+		auto res = mn::buf_new<Expr*>();
+		uint32_t count = cache_read_count(self);
+		for(uint32_t i = 0; i < count; ++i)
+			mn::buf_push(res, cache_read_expr(self));
+		return res;
+	}
+
+	inline static Type_Sign
+	cache_read_type_sign(AST_Cache_Reader& self);
+
+	inline static mn::Buf<Field>
+	cache_read_fields(AST_Cache_Reader& self)
+	{
+		auto res = mn::buf_new<Field>();
+		uint32_t count = cache_read_count(self);
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			Field field{};
+			field.ids = cache_read_ids(self);
+			field.type = cache_read_type_sign(self);
+			mn::buf_push(res, field);
+		}
+		return res;
+	}
+
+	inline static Type_Sign
+	cache_read_type_sign(AST_Cache_Reader& self)
+	{
+		auto res = mn::buf_new<Type_Atom>();
+		uint32_t count = cache_read_count(self);
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			auto kind = Type_Atom::KIND(cache_read_kind(self, Type_Atom::KIND_FUNC));
+			switch(kind)
+			{
+			case Type_Atom::KIND_NAMED:
+				mn::buf_push(res, type_atom_named(cache_read_tkn(self)));
+				break;
+
+			case Type_Atom::KIND_PTR:
+				mn::buf_push(res, type_atom_ptr());
+				break;
+
+			case Type_Atom::KIND_ARRAY:
+				mn::buf_push(res, type_atom_array(cache_read_tkn(self)));
+				break;
+
+			case Type_Atom::KIND_STRUCT:
+				mn::buf_push(res, type_atom_struct(cache_read_fields(self)));
+				break;
+
+			case Type_Atom::KIND_UNION:
+				mn::buf_push(res, type_atom_union(cache_read_fields(self)));
+				break;
+
+			case Type_Atom::KIND_ENUM:
+			{
+				auto fields = mn::buf_new<Enum_Field>();
+				uint32_t fields_count = cache_read_count(self);
+				for(uint32_t j = 0; j < fields_count; ++j)
+				{
+					Tkn id = cache_read_tkn(self);
+					Expr* expr = cache_read_expr(self);
+					mn::buf_push(fields, Enum_Field{ id, expr });
+				}
+				mn::buf_push(res, type_atom_enum(fields));
+				break;
+			}
+
+			case Type_Atom::KIND_FUNC:
+			{
+				auto args = mn::buf_new<Type_Sign>();
+				uint32_t args_count = cache_read_count(self);
+				for(uint32_t j = 0; j < args_count; ++j)
+					mn::buf_push(args, cache_read_type_sign(self));
+				Type_Sign ret = cache_read_type_sign(self);
+				mn::buf_push(res, type_atom_func(args, ret));
+				break;
+			}
+
+			default:
+				//no encoder writes an atom without a kind
+				cache_fail(self);
+				break;
+			}
+		}
+		return type_sign_from(self.src->ast.signs, res);
+	}
+
+	inline static Var
+	cache_read_var(AST_Cache_Reader& self)
+	{
+		Var res{};
+		res.ids = cache_read_ids(self);
+		res.type = cache_read_type_sign(self);
+		res.exprs = cache_read_exprs(self);
+		return res;
+	}
+
+	// reads the range and the fields of an expr of the given kind, its children are left empty for the walk
+	inline static Expr*
+	cache_read_expr_fields(AST_Cache_Reader& self, Expr::KIND kind)
+	{
+		Rng rng{};
+		Pos pos{};
+		cache_read_rng_pos(self, rng, pos);
+
+		Expr* res = nullptr;
+		switch(kind)
+		{
+		case Expr::KIND_ATOM:
+			res = expr_atom(cache_read_tkn(self));
+			break;
+
+		case Expr::KIND_BINARY:
+			res = expr_binary(nullptr, cache_read_tkn(self), nullptr);
+			break;
+
+		case Expr::KIND_UNARY:
+			res = expr_unary(cache_read_tkn(self), nullptr);
+			break;
+
+		case Expr::KIND_DOT:
+			res = expr_dot(nullptr, cache_read_tkn(self));
+			break;
+
+		case Expr::KIND_INDEXED:
+			res = expr_indexed(nullptr, nullptr);
+			break;
+
+		case Expr::KIND_CALL:
+		{
+			auto args = small_buf_new<Call_Args>();
+			small_buf_pushn(args, cache_read_count(self), (Expr*)nullptr);
+			res = expr_call(nullptr, args);
+			break;
+		}
+
+		case Expr::KIND_CAST:
+			res = expr_cast(nullptr, cache_read_type_sign(self));
+			break;
+
+		case Expr::KIND_PAREN:
+			res = expr_paren(nullptr);
+			break;
+
+		case Expr::KIND_COMPLIT:
+		{
+			Type_Sign type = cache_read_type_sign(self);
+			auto fields = mn::buf_new<Complit_Field>();
+			uint32_t count = cache_read_count(self);
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				Complit_Field field{};
+				field.kind = Complit_Field::KIND(cache_read_kind(self, Complit_Field::KIND_ARRAY));
+				mn::buf_push(fields, field);
+			}
+			res = expr_complit(type, fields);
+			break;
+		}
+
+		default:
+			assert(false && "unreachable");
+			return nullptr;
+		}
+
+		res->rng = rng;
+		res->pos = pos;
+		return res;
+	}
+
+	// sets the child at the given index in the order of expr_child, it returns false if there's no such child
+	inline static bool
+	cache_expr_child_set(Expr* self, size_t ix, Expr* child)
+	{
+		switch(self->kind)
+		{
+		case Expr::KIND_BINARY:
+			if(ix > 1)
+				return false;
+			(ix == 0 ? self->binary.lhs : self->binary.rhs) = child;
+			return true;
+		case Expr::KIND_UNARY:
+			self->unary.expr = child;
+			return ix == 0;
+		case Expr::KIND_DOT:
+			self->dot.base = child;
+			return ix == 0;
+		case Expr::KIND_INDEXED:
+			if(ix > 1)
+				return false;
+			(ix == 0 ? self->indexed.base : self->indexed.index) = child;
+			return true;
+		case Expr::KIND_CALL:
+			if(ix == 0)
+				self->call.base = child;
+			else if(ix - 1 < self->call.args.count)
+				self->call.args[ix - 1] = child;
+			else
+				return false;
+			return true;
+		case Expr::KIND_CAST:
+			self->cast.base = child;
+			return ix == 0;
+		case Expr::KIND_PAREN:
+			self->paren = child;
+			return ix == 0;
+		case Expr::KIND_COMPLIT:
+			if(ix / 2 >= self->complit.fields.count)
+				return false;
+			(ix % 2 == 0 ? self->complit.fields[ix / 2].left : self->complit.fields[ix / 2].right) = child;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	inline static Expr*
+	cache_read_expr_visit(AST_Cache_Reader& self, Expr* expr, size_t step)
+	{
+		auto kind = Expr::KIND(cache_read_kind(self, Expr::KIND_COMPLIT));
+		if(kind == Expr::KIND_NONE)
+			return nullptr;
+
+		//a child the expr can't have means the blob is corrupted, the child stays in the arena
+		Expr* child = cache_read_expr_fields(self, kind);
+		if(cache_expr_child_set(expr, step, child) == false)
+		{
+			cache_fail(self);
+			return nullptr;
+		}
+		return child;
+	}
+
+	inline static Expr*
+	cache_read_expr(AST_Cache_Reader& self)
+	{
+		auto kind = Expr::KIND(cache_read_kind(self, Expr::KIND_COMPLIT));
+		if(kind == Expr::KIND_NONE)
+			return nullptr;
+
+		Expr* res = cache_read_expr_fields(self, kind);
+		expr_walk(self.exprs_stack, res, self, cache_read_expr_visit);
+		return res;
+	}
+
+	inline static Stmt*
+	cache_read_stmt(AST_Cache_Reader& self)
+	{
+		auto kind = Stmt::KIND(cache_read_kind(self, Stmt::KIND_BLOCK));
+		if(kind == Stmt::KIND_NONE)
+			return nullptr;
+
+		Rng rng{};
+		Pos pos{};
+		cache_read_rng_pos(self, rng, pos);
+
+		Stmt* res = nullptr;
+		switch(kind)
+		{
+		case Stmt::KIND_BREAK:
+			res = stmt_break(cache_read_tkn(self));
+			break;
+
+		case Stmt::KIND_CONTINUE:
+			res = stmt_continue(cache_read_tkn(self));
+			break;
+
+		case Stmt::KIND_RETURN:
+			res = stmt_return(cache_read_expr(self));
+			break;
+
+		case Stmt::KIND_IF:
+		{
+			Expr* if_cond = cache_read_expr(self);
+			Stmt* if_body = cache_read_stmt(self);
+			auto else_ifs = mn::buf_new<Else_If>();
+			uint32_t count = cache_read_count(self);
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				Expr* cond = cache_read_expr(self);
+				Stmt* body = cache_read_stmt(self);
+				mn::buf_push(else_ifs, Else_If{cond, body});
+			}
+			Stmt* else_body = cache_read_stmt(self);
+			res = stmt_if(if_cond, if_body, else_ifs, else_body);
+			break;
+		}
+
+		case Stmt::KIND_FOR:
+		{
+			Stmt* init_stmt = cache_read_stmt(self);
+			Expr* loop_cond = cache_read_expr(self);
+			Stmt* post_stmt = cache_read_stmt(self);
+			Stmt* loop_body = cache_read_stmt(self);
+			res = stmt_for(init_stmt, loop_cond, post_stmt, loop_body);
+			break;
+		}
+
+		case Stmt::KIND_VAR:
+			res = stmt_var(cache_read_var(self));
+			break;
+
+		case Stmt::KIND_ASSIGN:
+		{
+			auto lhs = cache_read_exprs(self);
+			Tkn op = cache_read_tkn(self);
+			auto rhs = cache_read_exprs(self);
+			res = stmt_assign(lhs, op, rhs);
+			break;
+		}
+
+		case Stmt::KIND_EXPR:
+			res = stmt_expr(cache_read_expr(self));
+			break;
+
+		case Stmt::KIND_BLOCK:
+		{
+			auto stmts = mn::buf_new<Stmt*>();
+			uint32_t count = cache_read_count(self);
+			for(uint32_t i = 0; i < count; ++i)
+				mn::buf_push(stmts, cache_read_stmt(self));
+			res = stmt_block(stmts);
+			break;
+		}
+
+		default:
+			assert(false && "unreachable");
+			return nullptr;
+		}
+
+		res->rng = rng;
+		res->pos = pos;
+		return res;
+	}
+
+	inline static Decl*
+	cache_read_decl(AST_Cache_Reader& self)
+	{
+		auto kind = Decl::KIND(cache_read_kind(self, Decl::KIND_TYPE));
+		Tkn name = cache_read_tkn(self);
+		Rng rng{};
+		Pos pos{};
+		cache_read_rng_pos(self, rng, pos);
+
+		Decl* res = nullptr;
+		switch(kind)
+		{
+		case Decl::KIND_VAR:
+			res = decl_var(cache_read_var(self));
+			break;
+
+		case Decl::KIND_FUNC:
+		{
+			auto args = mn::buf_new<Arg>();
+			uint32_t count = cache_read_count(self);
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				Arg arg{};
+				arg.ids = cache_read_ids(self);
+				arg.type = cache_read_type_sign(self);
+				mn::buf_push(args, arg);
+			}
+			Type_Sign ret_type = cache_read_type_sign(self);
+			Stmt* body = cache_read_stmt(self);
+			res = decl_func(name, args, ret_type, body);
+			res->func_decl.lazy_body_open = cache_read_tkn(self);
+			break;
+		}
+
+		case Decl::KIND_TYPE:
+			res = decl_type(name, cache_read_type_sign(self));
+			break;
+
+		default:
+			//no encoder writes a decl without a kind
+			cache_fail(self);
+			return nullptr;
+		}
+
+		res->name = name;
+		res->rng = rng;
+		res->pos = pos;
+		return res;
+	}
+
+
+	//API
+	mn::Buf<uint8_t>
+	ast_cache_encode(Src *src, MODE mode, mn::Allocator allocator)
+	{
+		AST_Cache_Writer self{};
+		self.src = src;
+		self.nodes = mn::buf_new<uint8_t>();
+		self.strs = mn::buf_new<AST_Cache_Str>();
+		self.strs_index = mn::map_new<const char*, uint32_t>();
+		self.exprs_stack = mn::buf_new<Expr_Walk_Frame>();
+		mn_defer(mn::buf_free(self.nodes));
+		mn_defer(mn::buf_free(self.exprs_stack));
+		mn_defer(mn::buf_free(self.strs));
+		mn_defer(mn::map_free(self.strs_index));
+
+		cache_tkn(self, src->ast.package);
+		cache_tkns(self, src->ast.typenames);
+		cache_values(self, src->tkns.values);
+		cache_u32(self, uint32_t(src->ast.decls.count));
+		for(Decl* d: src->ast.decls)
+			cache_decl(self, d);
+
+		AST_Cache_Header header{};
+		::memcpy(header.magic, AST_CACHE_MAGIC, sizeof(header.magic));
+		header.version = AST_CACHE_VERSION;
+		header.mode = uint32_t(mode);
+		header.bodies = uint32_t(src->bodies);
+		header.strs_count = uint32_t(self.strs.count);
+		header.content_hash = cache_content_hash(src);
+		header.content_count = src->content.count;
+
+		auto res = mn::buf_with_allocator<uint8_t>(allocator);
+		cache_write(res, &header, sizeof(header));
+		for(const AST_Cache_Str& str: self.strs)
+		{
+			cache_write(res, &str.count, sizeof(str.count));
+			cache_write(res, str.ptr, str.count);
+		}
+		cache_write(res, self.nodes.ptr, self.nodes.count);
+
+		header.size = res.count;
+		::memcpy(res.ptr, &header, sizeof(header));
+		return res;
+	}
+
+	bool
+	ast_cache_decode(Src *src, MODE mode, const mn::Block& data)
+	{
+		AST_Cache_Reader self{};
+		self.src = src;
+		self.it = (const uint8_t*)data.ptr;
+		self.end = self.it + data.size;
+		self.strs = mn::buf_new<const char*>();
+		self.exprs_stack = mn::buf_new<Expr_Walk_Frame>();
+		mn_defer(mn::buf_free(self.strs));
+		mn_defer(mn::buf_free(self.exprs_stack));
+
+		AST_Cache_Header header{};
+		cache_read(self, &header, sizeof(header));
+		if (self.failed ||
+			::memcmp(header.magic, AST_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+			header.version != AST_CACHE_VERSION ||
+			header.mode != uint32_t(mode) ||
+			header.bodies != uint32_t(src->bodies) ||
+			header.size != data.size ||
+			header.content_count != src->content.count ||
+			header.content_hash != cache_content_hash(src))
+		{
+			return false;
+		}
+
+		//the strings are interned again so they're the same pointers as the ones the scanner makes
+		for(uint32_t i = 0; i < header.strs_count && self.failed == false; ++i)
+		{
+			uint32_t count = cache_read_count(self);
+			auto str = (const char*)self.it;
+			self.it += count;
+			mn::buf_push(self.strs, intern_pool_get(src->str_table, str, str + count));
+		}
+
+		mn::allocator_push(src->ast.arena);
+		Tkn package = cache_read_tkn(self);
+		uint32_t typenames_count = cache_read_count(self);
+		for(uint32_t i = 0; i < typenames_count; ++i)
+		{
+			Tkn tkn = cache_read_tkn(self);
+			if(tkn.str)
+				ast_typename_add(src->ast, tkn);
+		}
+		auto values = mn::buf_new<Tkn_Value>();
+		mn_defer(mn::buf_free(values));
+		cache_read_values(self, values);
+		uint32_t decls_count = cache_read_count(self);
+		for(uint32_t i = 0; i < decls_count && self.failed == false; ++i)
+			mn::buf_push(src->ast.decls, cache_read_decl(self));
+		mn::allocator_pop();
+
+		if(self.failed || self.it != self.end)
+		{
+			//the nodes we read so far are left in the arena until the AST is freed
+			mn::buf_clear(src->ast.decls);
+			mn::buf_clear(src->ast.typenames);
+			mn::buf_clear(src->ast.typenames_set);
+			return false;
+		}
+
+		src->ast.package = package;
+		mn::buf_clear(src->tkns.values);
+		mn::buf_concat(src->tkns.values, values);
+		return true;
+	}
+
+	mn::Str
+	ast_cache_path(Src *src, MODE mode, const char* folder, mn::Allocator allocator)
+	{
+		return mn::strf(
+			mn::str_with_allocator(allocator),
+			"{}/{}-{}-{}-v{}.zast",
+			folder,
+			cache_content_hash(src),
+			int(mode),
+			int(src->bodies),
+			AST_CACHE_VERSION
+		);
+	}
+
+	bool
+	src_scan_parse_cached(Src *src, MODE mode, const char* folder)
+	{
+		auto path = ast_cache_path(src, mode, folder, mn::memory::tmp());
+		if(mn::path_is_file(path))
+		{
+			//the strings are interned and the nodes are built while decoding so the mapping isn't needed after it
+			auto data = file_map(path.ptr);
+			bool hit = data.count > 0 && ast_cache_decode(src, mode, mn::block_from(data));
+			file_unmap(data);
+			if(hit)
+				return true;
+		}
+
+		if(src_scan_parse(src, mode) == false)
+			return false;
+
+		//we don't fail the build if we can't write the cache, it's only a miss next time
+		auto data = ast_cache_encode(src, mode, mn::memory::tmp());
+		auto file = mn::file_open(path, mn::IO_MODE::WRITE, mn::OPEN_MODE::CREATE_OVERWRITE);
+		if(file)
+		{
+			mn::file_write(file, mn::block_from(data));
+			mn::file_close(file);
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -20,12 +20,12 @@ namespace zay
 	ast_lisp_type_sign(AST_Lisp& self, const Type_Sign& type)
 	{
 		mn::print_to(self.out, "(type-sign ");
-		for(size_t i = 0; i < type.count; ++i)
+		for(size_t i = 0; i < type_sign_count(type); ++i)
 		{
-			switch(type[i].kind)
+			switch(type->atoms[i].kind)
 			{
 			case Type_Atom::KIND_NAMED:
-				mn::print_to(self.out, " {}", type[i].named.str);
+				mn::print_to(self.out, " {}", type->atoms[i].named.str);
 				break;
 
 			case Type_Atom::KIND_PTR:
@@ -33,13 +33,13 @@ namespace zay
 				break;
 
 			case Type_Atom::KIND_ARRAY:
-				mn::print_to(self.out, "[{}]", type[i].count.str);
+				mn::print_to(self.out, "[{}]", type->atoms[i].count.str);
 				break;
 
 			case Type_Atom::KIND_STRUCT:
 				mn::print_to(self.out, "(struct\n");
 				self.level++;
-				for (const Field& field : type[i].struct_fields)
+				for (const Field& field : type->atoms[i].struct_fields)
 				{
 					ast_lisp_indent(self);
 					ast_lisp_field(self, field);
@@ -53,7 +53,7 @@ namespace zay
 			case Type_Atom::KIND_UNION:
 				mn::print_to(self.out, "(union\n");
 				self.level++;
-				for (const Field& field : type[i].union_fields)
+				for (const Field& field : type->atoms[i].union_fields)
 				{
 					ast_lisp_indent(self);
 					ast_lisp_field(self, field);
@@ -67,7 +67,7 @@ namespace zay
 			case Type_Atom::KIND_ENUM:
 				mn::print_to(self.out, "(enum\n");
 				self.level++;
-				for (const Enum_Field& field : type[i].enum_fields)
+				for (const Enum_Field& field : type->atoms[i].enum_fields)
 				{
 					ast_lisp_indent(self);
 					mn::print_to(self.out, "(field {}", field.id.str);
@@ -126,7 +126,7 @@ namespace zay
 
 		self.level++;
 
-		if(v.type.count != 0)
+		if(v.type != nullptr)
 		{
 			mn::print_to(self.out, "\n");
 			ast_lisp_indent(self);
@@ -188,7 +188,7 @@ namespace zay
 		}
 
 		//write the ret type
-		if(decl->func_decl.ret_type.count != 0)
+		if(decl->func_decl.ret_type != nullptr)
 		{
 			mn::print_to(self.out, "\n");
 			ast_lisp_indent(self);
@@ -235,96 +235,165 @@ namespace zay
 		mn::print_to(self.out, "(atom {})", expr->atom.str);
 	}
 
-	inline static void
-	ast_lisp_binary(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_binary(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(binary {} ", expr->binary.op.str);
-		ast_lisp_expr(self, expr->binary.lhs);
-
-		mn::print_to(self.out, " ");
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(binary {} ", expr->binary.op.str);
+			return expr->binary.lhs;
+		}
 
-		ast_lisp_expr(self, expr->binary.rhs);
+		if(step == 1)
+		{
+			mn::print_to(self.out, " ");
+			return expr->binary.rhs;
+		}
 
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_unary(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_unary(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(unary {} ", expr->unary.op.str);
-		ast_lisp_expr(self, expr->unary.expr);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(unary {} ", expr->unary.op.str);
+			return expr->unary.expr;
+		}
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_dot(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_dot(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(dot ");
-		ast_lisp_expr(self, expr->dot.base);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(dot ");
+			return expr->dot.base;
+		}
 		mn::print_to(self.out, ".{})", expr->dot.member.str);
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_indexed(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_indexed(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(indexed ");
-		ast_lisp_expr(self, expr->indexed.base);
-		mn::print_to(self.out, "[");
-		ast_lisp_expr(self, expr->indexed.index);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(indexed ");
+			return expr->indexed.base;
+		}
+
+		if(step == 1)
+		{
+			mn::print_to(self.out, "[");
+			return expr->indexed.index;
+		}
+
 		mn::print_to(self.out, "])");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_call(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_call(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(call ");
-		ast_lisp_expr(self, expr->call.base);
-		mn::print_to(self.out, " ");
-		for(size_t i = 0; i < expr->call.args.count; ++i)
+		if(step == 0)
 		{
-			if(i != 0)
+			mn::print_to(self.out, "(call ");
+			return expr->call.base;
+		}
+
+		//step i comes once the base and the first i - 1 args are written
+		if(step == 1)
+			mn::print_to(self.out, " ");
+		if(step - 1 < expr->call.args.count)
+		{
+			if(step != 1)
 				mn::print_to(self.out, ", ");
-			ast_lisp_expr(self, expr->call.args[i]);
+			return expr->call.args[step - 1];
 		}
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_cast(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_cast(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(cast ");
-		ast_lisp_expr(self, expr->cast.base);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(cast ");
+			return expr->cast.base;
+		}
 		ast_lisp_type_sign(self, expr->cast.type);
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_paren(AST_Lisp& self, Expr* expr)
+	inline static Expr*
+	ast_lisp_paren(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(paren ");
-		ast_lisp_expr(self, expr->paren);
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(paren ");
+			return expr->paren;
+		}
 		mn::print_to(self.out, ")");
+		return nullptr;
 	}
 
-	inline static void
-	ast_lisp_complit(AST_Lisp& self, Expr* expr)
+	//the fields are walked left then right so step 2i + 1 comes after the left of field i and step 2i + 2
+	//after its right
+	inline static Expr*
+	ast_lisp_complit(AST_Lisp& self, Expr* expr, size_t step)
 	{
-		mn::print_to(self.out, "(complit ");
-		ast_lisp_type_sign(self, expr->complit.type);
-		mn::print_to(self.out, "\n");
-		self.level++;
-		for(const Complit_Field& f: expr->complit.fields)
+		if(step == 0)
+		{
+			mn::print_to(self.out, "(complit ");
+			ast_lisp_type_sign(self, expr->complit.type);
+			mn::print_to(self.out, "\n");
+			self.level++;
+		}
+		else if(step % 2 == 1)
 		{
-			ast_lisp_indent(self);
-			ast_lisp_expr(self, f.left);
 			mn::print_to(self.out, " ");
-			ast_lisp_expr(self, f.right);
+			return expr->complit.fields[step / 2].right;
+		}
+		else
+		{
 			mn::print_to(self.out, "\n");
 		}
-		
+
+		if(step / 2 < expr->complit.fields.count)
+		{
+			ast_lisp_indent(self);
+			return expr->complit.fields[step / 2].left;
+		}
+
 		self.level--;
 		ast_lisp_indent(self);
 		mn::print_to(self.out, ")");
+		return nullptr;
+	}
+
+	inline static Expr*
+	ast_lisp_expr_visit(AST_Lisp& self, Expr* expr, size_t step)
+	{
+		switch(expr->kind)
+		{
+		case Expr::KIND_ATOM: ast_lisp_atom(self, expr); return nullptr;
+		case Expr::KIND_BINARY: return ast_lisp_binary(self, expr, step);
+		case Expr::KIND_UNARY: return ast_lisp_unary(self, expr, step);
+		case Expr::KIND_DOT: return ast_lisp_dot(self, expr, step);
+		case Expr::KIND_INDEXED: return ast_lisp_indexed(self, expr, step);
+		case Expr::KIND_CALL: return ast_lisp_call(self, expr, step);
+		case Expr::KIND_CAST: return ast_lisp_cast(self, expr, step);
+		case Expr::KIND_PAREN: return ast_lisp_paren(self, expr, step);
+		case Expr::KIND_COMPLIT: return ast_lisp_complit(self, expr, step);
+		default: assert(false && "unreachable"); return nullptr;
+		}
 	}
 
 
@@ -516,23 +585,370 @@ namespace zay
 	}
 
 
+	//Flat AST
+	inline static void
+	ast_lisp_flat_field(AST_Lisp& self, const Flat_AST& ast, Flat_Ix field);
+
+	inline static void
+	ast_lisp_flat_type_sign(AST_Lisp& self, const Flat_AST& ast, Flat_Ix sign)
+	{
+		mn::print_to(self.out, "(type-sign ");
+		for(uint32_t i = 0; i < ast.extra[sign]; ++i)
+		{
+			const Flat_Node& atom = ast.types[ast.extra[sign + 1 + i]];
+			switch(atom.kind)
+			{
+			case Type_Atom::KIND_NAMED:
+				mn::print_to(self.out, " {}", ast.tkns[atom.tkn].str);
+				break;
+
+			case Type_Atom::KIND_PTR:
+				mn::print_to(self.out, "*");
+				break;
+
+			case Type_Atom::KIND_ARRAY:
+				mn::print_to(self.out, "[{}]", ast.tkns[atom.tkn].str);
+				break;
+
+			case Type_Atom::KIND_STRUCT:
+			case Type_Atom::KIND_UNION:
+				if(atom.kind == Type_Atom::KIND_STRUCT)
+					mn::print_to(self.out, "(struct\n");
+				else
+					mn::print_to(self.out, "(union\n");
+				self.level++;
+				for(uint32_t j = 0; j < ast.extra[atom.lhs]; ++j)
+				{
+					ast_lisp_indent(self);
+					ast_lisp_flat_field(self, ast, ast.extra[atom.lhs + 1 + j]);
+					mn::print_to(self.out, "\n");
+				}
+				self.level--;
+				ast_lisp_indent(self);
+				mn::print_to(self.out, ")");
+				break;
+
+			case Type_Atom::KIND_ENUM:
+				mn::print_to(self.out, "(enum\n");
+				self.level++;
+				for(uint32_t j = 0; j < ast.extra[atom.lhs]; ++j)
+				{
+					ast_lisp_indent(self);
+					mn::print_to(self.out, "(field {}", ast.tkns[ast.extra[atom.lhs + 1 + j * 2]].str);
+					Flat_Ix expr = ast.extra[atom.lhs + 2 + j * 2];
+					if (expr != FLAT_NIL)
+					{
+						mn::print_to(self.out, " ");
+						ast_lisp_expr(self, ast, expr);
+					}
+					mn::print_to(self.out, ")");
+					mn::print_to(self.out, "\n");
+				}
+				self.level--;
+				ast_lisp_indent(self);
+				mn::print_to(self.out, ")");
+				break;
+
+			default:
+				assert(false && "unreachable");
+				break;
+			}
+		}
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_ids(AST_Lisp& self, const Flat_AST& ast, Flat_Ix record)
+	{
+		for(uint32_t i = 0; i < ast.extra[record]; ++i)
+		{
+			if(i != 0)
+				mn::print_to(self.out, ", ");
+			mn::print_to(self.out, "{}", ast.tkns[ast.extra[record + 1 + i]].str);
+		}
+	}
+
+	inline static void
+	ast_lisp_flat_field(AST_Lisp& self, const Flat_AST& ast, Flat_Ix field)
+	{
+		mn::print_to(self.out, "(field ");
+		ast_lisp_flat_ids(self, ast, field);
+		mn::print_to(self.out, ": ");
+		ast_lisp_flat_type_sign(self, ast, ast.extra[field + 1 + ast.extra[field]]);
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_exprs(AST_Lisp& self, const Flat_AST& ast, Flat_Ix list)
+	{
+		for(uint32_t i = 0; i < ast.extra[list]; ++i)
+		{
+			if(i == 0)
+			{
+				mn::print_to(self.out, "\n");
+				ast_lisp_indent(self);
+			}
+			else
+			{
+				mn::print_to(self.out, ", ");
+			}
+			ast_lisp_expr(self, ast, ast.extra[list + 1 + i]);
+		}
+	}
+
+	inline static void
+	ast_lisp_flat_variable(AST_Lisp& self, const Flat_AST& ast, Flat_Ix var)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(var ");
+		ast_lisp_flat_ids(self, ast, var);
+
+		self.level++;
+
+		Flat_Ix sign = ast.extra[var + 1 + ast.extra[var]];
+		if(ast.extra[sign] != 0)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_indent(self);
+			ast_lisp_flat_type_sign(self, ast, sign);
+		}
+
+		ast_lisp_flat_exprs(self, ast, ast.extra[var + 2 + ast.extra[var]]);
+
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_func(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& decl)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(func {}", ast.tkns[decl.tkn].str);
+
+		self.level++;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		//write the args
+		for(uint32_t i = 0; i < ast.extra[decl.lhs + 2]; ++i)
+		{
+			Flat_Ix arg = ast.extra[decl.lhs + 3 + i];
+			ast_lisp_flat_ids(self, ast, arg);
+			mn::print_to(self.out, ": ");
+			ast_lisp_flat_type_sign(self, ast, ast.extra[arg + 1 + ast.extra[arg]]);
+			mn::print_to(self.out, " ");
+		}
+
+		//write the ret type
+		Flat_Ix ret = ast.extra[decl.lhs];
+		if(ast.extra[ret] != 0)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_indent(self);
+			mn::print_to(self.out, ": ");
+			ast_lisp_flat_type_sign(self, ast, ret);
+		}
+
+		Flat_Ix body = ast.extra[decl.lhs + 1];
+		if(body != FLAT_NIL)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_stmt(self, ast, body);
+		}
+
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_type_decl(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& decl)
+	{
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, "(type-decl {}\n", ast.tkns[decl.tkn].str);
+
+		self.level++;
+		ast_lisp_indent(self);
+
+		ast_lisp_flat_type_sign(self, ast, decl.lhs);
+
+		mn::print_to(self.out, "\n");
+		self.level--;
+		ast_lisp_indent(self);
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_complit(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& expr)
+	{
+		mn::print_to(self.out, "(complit ");
+		ast_lisp_flat_type_sign(self, ast, expr.lhs);
+		mn::print_to(self.out, "\n");
+		self.level++;
+		for(uint32_t i = 0; i < ast.extra[expr.rhs]; ++i)
+		{
+			ast_lisp_indent(self);
+			ast_lisp_expr(self, ast, ast.extra[expr.rhs + 2 + i * 3]);
+			mn::print_to(self.out, " ");
+			ast_lisp_expr(self, ast, ast.extra[expr.rhs + 3 + i * 3]);
+			mn::print_to(self.out, "\n");
+		}
+
+		self.level--;
+		ast_lisp_indent(self);
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_stmt_if(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& stmt)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(if ");
+		ast_lisp_expr(self, ast, stmt.lhs);
+
+		self.level++;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_stmt(self, ast, ast.extra[stmt.rhs]);
+
+		for(uint32_t i = 0; i < ast.extra[stmt.rhs + 2]; ++i)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_indent(self);
+			ast_lisp_expr(self, ast, ast.extra[stmt.rhs + 3 + i * 2]);
+
+			mn::print_to(self.out, "\n");
+			ast_lisp_stmt(self, ast, ast.extra[stmt.rhs + 4 + i * 2]);
+		}
+
+		mn::print_to(self.out, "\n");
+		Flat_Ix else_body = ast.extra[stmt.rhs + 1];
+		if(else_body != FLAT_NIL)
+			ast_lisp_stmt(self, ast, else_body);
+
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_stmt_for(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& stmt)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(for");
+
+		self.level++;
+
+		Flat_Ix init = ast.extra[stmt.lhs];
+		if(init != FLAT_NIL)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_stmt(self, ast, init);
+		}
+
+		Flat_Ix cond = ast.extra[stmt.lhs + 1];
+		if(cond != FLAT_NIL)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_indent(self);
+			ast_lisp_expr(self, ast, cond);
+		}
+
+		Flat_Ix post = ast.extra[stmt.lhs + 2];
+		if(post != FLAT_NIL)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_stmt(self, ast, post);
+		}
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_stmt(self, ast, ast.extra[stmt.lhs + 3]);
+
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_stmt_assign(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& stmt)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "({} ", ast.tkns[stmt.tkn].str);
+
+		self.level++;
+		ast_lisp_flat_exprs(self, ast, stmt.lhs);
+		ast_lisp_flat_exprs(self, ast, stmt.rhs);
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_stmt_expr(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& stmt)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(expr-stmt");
+
+		self.level++;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+		ast_lisp_expr(self, ast, stmt.lhs);
+
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+	inline static void
+	ast_lisp_flat_stmt_block(AST_Lisp& self, const Flat_AST& ast, const Flat_Node& stmt)
+	{
+		ast_lisp_indent(self);
+		mn::print_to(self.out, "(block-stmt");
+
+		self.level++;
+		for(uint32_t i = 0; i < ast.extra[stmt.lhs]; ++i)
+		{
+			mn::print_to(self.out, "\n");
+			ast_lisp_stmt(self, ast, ast.extra[stmt.lhs + 1 + i]);
+		}
+		self.level--;
+
+		mn::print_to(self.out, "\n");
+		ast_lisp_indent(self);
+
+		mn::print_to(self.out, ")");
+	}
+
+
 	//API
 	void
 	ast_lisp_expr(AST_Lisp& self, Expr* expr)
 	{
-		switch(expr->kind)
-		{
-		case Expr::KIND_ATOM: ast_lisp_atom(self, expr); break;
-		case Expr::KIND_BINARY: ast_lisp_binary(self, expr); break;
-		case Expr::KIND_UNARY: ast_lisp_unary(self, expr); break;
-		case Expr::KIND_DOT: ast_lisp_dot(self, expr); break;
-		case Expr::KIND_INDEXED: ast_lisp_indexed(self, expr); break;
-		case Expr::KIND_CALL: ast_lisp_call(self, expr); break;
-		case Expr::KIND_CAST: ast_lisp_cast(self, expr); break;
-		case Expr::KIND_PAREN: ast_lisp_paren(self, expr); break;
-		case Expr::KIND_COMPLIT: ast_lisp_complit(self, expr); break;
-		default: assert(false && "unreachable"); break;
-		}
+		auto stack = mn::buf_with_allocator<Expr_Walk_Frame>(mn::memory::clib());
+		expr_walk(stack, expr, self, ast_lisp_expr_visit);
+		mn::buf_free(stack);
 	}
 
 	void
@@ -573,4 +989,124 @@ namespace zay
 		default: assert(false && "unreachable"); break;
 		}
 	}
+
+	void
+	ast_lisp_expr(AST_Lisp& self, const Flat_AST& ast, Flat_Ix expr)
+	{
+		const Flat_Node& node = ast.exprs[expr];
+		switch(node.kind)
+		{
+		case Expr::KIND_ATOM:
+			mn::print_to(self.out, "(atom {})", ast.tkns[node.tkn].str);
+			break;
+
+		case Expr::KIND_BINARY:
+			mn::print_to(self.out, "(binary {} ", ast.tkns[node.tkn].str);
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, " ");
+			ast_lisp_expr(self, ast, node.rhs);
+			mn::print_to(self.out, ")");
+			break;
+
+		case Expr::KIND_UNARY:
+			mn::print_to(self.out, "(unary {} ", ast.tkns[node.tkn].str);
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, ")");
+			break;
+
+		case Expr::KIND_DOT:
+			mn::print_to(self.out, "(dot ");
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, ".{})", ast.tkns[node.tkn].str);
+			break;
+
+		case Expr::KIND_INDEXED:
+			mn::print_to(self.out, "(indexed ");
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, "[");
+			ast_lisp_expr(self, ast, node.rhs);
+			mn::print_to(self.out, "])");
+			break;
+
+		case Expr::KIND_CALL:
+			mn::print_to(self.out, "(call ");
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, " ");
+			for(uint32_t i = 0; i < ast.extra[node.rhs]; ++i)
+			{
+				if(i != 0)
+					mn::print_to(self.out, ", ");
+				ast_lisp_expr(self, ast, ast.extra[node.rhs + 1 + i]);
+			}
+			mn::print_to(self.out, ")");
+			break;
+
+		case Expr::KIND_CAST:
+			mn::print_to(self.out, "(cast ");
+			ast_lisp_expr(self, ast, node.lhs);
+			ast_lisp_flat_type_sign(self, ast, node.rhs);
+			mn::print_to(self.out, ")");
+			break;
+
+		case Expr::KIND_PAREN:
+			mn::print_to(self.out, "(paren ");
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, ")");
+			break;
+
+		case Expr::KIND_COMPLIT: ast_lisp_flat_complit(self, ast, node); break;
+		default: assert(false && "unreachable"); break;
+		}
+	}
+
+	void
+	ast_lisp_stmt(AST_Lisp& self, const Flat_AST& ast, Flat_Ix stmt)
+	{
+		const Flat_Node& node = ast.stmts[stmt];
+		switch(node.kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+			ast_lisp_indent(self);
+			mn::print_to(self.out, "({})", ast.tkns[node.tkn].str);
+			break;
+
+		case Stmt::KIND_RETURN:
+			ast_lisp_indent(self);
+			mn::print_to(self.out, "(return ");
+			ast_lisp_expr(self, ast, node.lhs);
+			mn::print_to(self.out, ")");
+			break;
+
+		case Stmt::KIND_IF: ast_lisp_flat_stmt_if(self, ast, node); break;
+		case Stmt::KIND_FOR: ast_lisp_flat_stmt_for(self, ast, node); break;
+		case Stmt::KIND_VAR: ast_lisp_flat_variable(self, ast, node.lhs); break;
+		case Stmt::KIND_ASSIGN: ast_lisp_flat_stmt_assign(self, ast, node); break;
+		case Stmt::KIND_EXPR: ast_lisp_flat_stmt_expr(self, ast, node); break;
+		case Stmt::KIND_BLOCK: ast_lisp_flat_stmt_block(self, ast, node); break;
+		default: assert(false && "unreachable"); break;
+		}
+	}
+
+	void
+	ast_lisp_decl(AST_Lisp& self, const Flat_AST& ast, Flat_Ix decl)
+	{
+		const Flat_Node& node = ast.decls[decl];
+		switch(node.kind)
+		{
+		case Decl::KIND_VAR:
+			ast_lisp_flat_variable(self, ast, node.lhs);
+			break;
+
+		case Decl::KIND_FUNC:
+			ast_lisp_flat_func(self, ast, node);
+			break;
+
+		case Decl::KIND_TYPE:
+			ast_lisp_flat_type_decl(self, ast, node);
+			break;
+
+		default: assert(false && "unreachable"); break;
+		}
+	}
 }
\ No newline at end of file
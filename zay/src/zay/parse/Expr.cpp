@@ -8,7 +8,7 @@ namespace zay
 	Expr*
 	expr_atom(const Tkn& t)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_ATOM;
 		self->atom = t;
@@ -18,7 +18,7 @@ namespace zay
 	Expr*
 	expr_paren(Expr* e)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_PAREN;
 		self->paren = e;
@@ -26,9 +26,9 @@ namespace zay
 	}
 
 	Expr*
-	expr_call(Expr* base, const mn::Buf<Expr*>& args)
+	expr_call(Expr* base, const Call_Args& args)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_CALL;
 		self->call.base = base;
@@ -39,7 +39,7 @@ namespace zay
 	Expr*
 	expr_indexed(Expr* base, Expr* index)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_INDEXED;
 		self->indexed.base = base;
@@ -50,7 +50,7 @@ namespace zay
 	Expr*
 	expr_dot(Expr* base, const Tkn& t)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_DOT;
 		self->dot.base = base;
@@ -61,7 +61,7 @@ namespace zay
 	Expr*
 	expr_unary(const Tkn& op, Expr* expr)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_UNARY;
 		self->unary.op = op;
@@ -72,7 +72,7 @@ namespace zay
 	Expr*
 	expr_cast(Expr* expr, const Type_Sign& type)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_CAST;
 		self->cast.base = expr;
@@ -83,7 +83,7 @@ namespace zay
 	Expr*
 	expr_binary(Expr* lhs, const Tkn& op, Expr* rhs)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_BINARY;
 		self->binary.lhs = lhs;
@@ -95,7 +95,7 @@ namespace zay
 	Expr*
 	expr_complit(const Type_Sign& type, const mn::Buf<Complit_Field>& fields)
 	{
-		auto self = mn::alloc<Expr>();
+		auto self = mn::alloc_zerod<Expr>();
 		self->type = type_void;
 		self->kind = Expr::KIND_COMPLIT;
 		self->complit.type = type;
@@ -103,48 +103,83 @@ namespace zay
 		return self;
 	}
 
-	void
-	expr_free(Expr* self)
+	//the children are freed before their parent so it can still find them
+	inline static Expr*
+	expr_free_visit(mn::Allocator& allocator, Expr* self, size_t step)
 	{
+		if(Expr* child = expr_child(self, step))
+			return child;
+
 		switch (self->kind)
 		{
-		case Expr::KIND_ATOM: break;
-		case Expr::KIND_BINARY:
-			expr_free(self->binary.lhs);
-			expr_free(self->binary.rhs);
-			break;
-		case Expr::KIND_UNARY:
-			expr_free(self->unary.expr);
-			break;
-		case Expr::KIND_DOT:
-			expr_free(self->dot.base);
-			break;
-		case Expr::KIND_INDEXED:
-			expr_free(self->indexed.base);
-			expr_free(self->indexed.index);
-			break;
 		case Expr::KIND_CALL:
-			expr_free(self->call.base);
-			destruct(self->call.args);
+			small_buf_free(self->call.args);
 			break;
 		case Expr::KIND_CAST:
-			expr_free(self->cast.base);
 			type_sign_free(self->cast.type);
 			break;
-		case Expr::KIND_PAREN:
-			expr_free(self->paren);
-			break;
 		case Expr::KIND_COMPLIT:
 			type_sign_free(self->complit.type);
-			for (const Complit_Field& f : self->complit.fields)
-			{
-				expr_free(f.left);
-				expr_free(f.right);
-			}
 			mn::buf_free(self->complit.fields);
 			break;
-		default: assert(false && "unreachable"); break;
+		default:
+			break;
+		}
+		mn::free_from(allocator, self);
+		return nullptr;
+	}
+
+	void
+	expr_free(Expr* self)
+	{
+		auto stack = mn::buf_with_allocator<Expr_Walk_Frame>(mn::memory::clib());
+		mn::Allocator allocator = mn::allocator_top();
+		expr_walk(stack, self, allocator, expr_free_visit);
+		mn::buf_free(stack);
+	}
+
+	Expr*
+	expr_child(Expr* self, size_t ix)
+	{
+		switch(self->kind)
+		{
+		case Expr::KIND_ATOM:
+			return nullptr;
+		case Expr::KIND_BINARY:
+			if(ix == 0)
+				return self->binary.lhs;
+			else if(ix == 1)
+				return self->binary.rhs;
+			return nullptr;
+		case Expr::KIND_UNARY:
+			return ix == 0 ? self->unary.expr : nullptr;
+		case Expr::KIND_DOT:
+			return ix == 0 ? self->dot.base : nullptr;
+		case Expr::KIND_INDEXED:
+			if(ix == 0)
+				return self->indexed.base;
+			else if(ix == 1)
+				return self->indexed.index;
+			return nullptr;
+		case Expr::KIND_CALL:
+			if(ix == 0)
+				return self->call.base;
+			else if(ix - 1 < self->call.args.count)
+				return self->call.args[ix - 1];
+			return nullptr;
+		case Expr::KIND_CAST:
+			return ix == 0 ? self->cast.base : nullptr;
+		case Expr::KIND_PAREN:
+			return ix == 0 ? self->paren : nullptr;
+		case Expr::KIND_COMPLIT:
+			if(ix / 2 >= self->complit.fields.count)
+				return nullptr;
+			else if(ix % 2 == 0)
+				return self->complit.fields[ix / 2].left;
+			return self->complit.fields[ix / 2].right;
+		default:
+			assert(false && "unreachable");
+			return nullptr;
 		}
-		mn::free(self);
 	}
-}
+}
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "zay/parse/Flat_AST.h"
+
+#include <assert.h>
+
+namespace zay
+{
+	inline static Flat_Ix
+	flat_type_sign(Flat_AST& self, const Type_Sign& sign);
+
+	inline static uint32_t
+	flat_tkn(Flat_AST& self, const Tkn& tkn)
+	{
+		mn::buf_push(self.tkns, tkn);
+		return uint32_t(self.tkns.count - 1);
+	}
+
+	inline static Flat_Ix
+	flat_node(mn::Buf<Flat_Node>& nodes, uint8_t kind, uint32_t tkn, Flat_Ix lhs, Flat_Ix rhs)
+	{
+		mn::buf_push(nodes, Flat_Node{kind, tkn, lhs, rhs});
+		return Flat_Ix(nodes.count - 1);
+	}
+
+	// reserves a record of the given size in extra, the children are flattened after reserving it so
+	// the record is filled by index because extra might grow in the meantime
+	inline static Flat_Ix
+	flat_record(Flat_AST& self, size_t size)
+	{
+		size_t ix = self.extra.count;
+		mn::buf_resize_fill(self.extra, ix + size, FLAT_NIL);
+		return Flat_Ix(ix);
+	}
+
+	inline static Flat_Ix
+	flat_expr_list(Flat_AST& self, const mn::Buf<Expr*>& exprs)
+	{
+		Flat_Ix record = flat_record(self, exprs.count + 1);
+		self.extra[record] = uint32_t(exprs.count);
+		for(size_t i = 0; i < exprs.count; ++i)
+		{
+			Flat_Ix expr = flat_ast_expr(self, exprs[i]);
+			self.extra[record + 1 + i] = expr;
+		}
+		return record;
+	}
+
+	inline static Flat_Ix
+	flat_expr_list(Flat_AST& self, const Call_Args& args)
+	{
+		Flat_Ix record = flat_record(self, args.count + 1);
+		self.extra[record] = uint32_t(args.count);
+		for(size_t i = 0; i < args.count; ++i)
+		{
+			Flat_Ix expr = flat_ast_expr(self, args[i]);
+			self.extra[record + 1 + i] = expr;
+		}
+		return record;
+	}
+
+	inline static Flat_Ix
+	flat_field(Flat_AST& self, const Id_List& ids, const Type_Sign& type)
+	{
+		Flat_Ix record = flat_record(self, ids.count + 2);
+		self.extra[record] = uint32_t(ids.count);
+		for(size_t i = 0; i < ids.count; ++i)
+		{
+			uint32_t id = flat_tkn(self, ids[i]);
+			self.extra[record + 1 + i] = id;
+		}
+		Flat_Ix sign = flat_type_sign(self, type);
+		self.extra[record + 1 + ids.count] = sign;
+		return record;
+	}
+
+	inline static Flat_Ix
+	flat_fields(Flat_AST& self, const mn::Buf<Field>& fields)
+	{
+		Flat_Ix record = flat_record(self, fields.count + 1);
+		self.extra[record] = uint32_t(fields.count);
+		for(size_t i = 0; i < fields.count; ++i)
+		{
+			Flat_Ix field = flat_field(self, fields[i].ids, fields[i].type);
+			self.extra[record + 1 + i] = field;
+		}
+		return record;
+	}
+
+	inline static Flat_Ix
+	flat_var(Flat_AST& self, const Var& v)
+	{
+		Flat_Ix record = flat_record(self, v.ids.count + 3);
+		self.extra[record] = uint32_t(v.ids.count);
+		for(size_t i = 0; i < v.ids.count; ++i)
+		{
+			uint32_t id = flat_tkn(self, v.ids[i]);
+			self.extra[record + 1 + i] = id;
+		}
+		Flat_Ix sign = flat_type_sign(self, v.type);
+		self.extra[record + 1 + v.ids.count] = sign;
+		Flat_Ix exprs = flat_expr_list(self, v.exprs);
+		self.extra[record + 2 + v.ids.count] = exprs;
+		return record;
+	}
+
+	inline static Flat_Ix
+	flat_type_atom(Flat_AST& self, const Type_Atom& atom)
+	{
+		switch(atom.kind)
+		{
+		case Type_Atom::KIND_NAMED:
+			return flat_node(self.types, atom.kind, flat_tkn(self, atom.named), FLAT_NIL, FLAT_NIL);
+
+		case Type_Atom::KIND_PTR:
+			return flat_node(self.types, atom.kind, FLAT_NIL, FLAT_NIL, FLAT_NIL);
+
+		case Type_Atom::KIND_ARRAY:
+			return flat_node(self.types, atom.kind, flat_tkn(self, atom.count), FLAT_NIL, FLAT_NIL);
+
+		case Type_Atom::KIND_STRUCT:
+			return flat_node(self.types, atom.kind, FLAT_NIL, flat_fields(self, atom.struct_fields), FLAT_NIL);
+
+		case Type_Atom::KIND_UNION:
+			return flat_node(self.types, atom.kind, FLAT_NIL, flat_fields(self, atom.union_fields), FLAT_NIL);
+
+		case Type_Atom::KIND_ENUM:
+		{
+			const auto& fields = atom.enum_fields;
+			Flat_Ix record = flat_record(self, fields.count * 2 + 1);
+			self.extra[record] = uint32_t(fields.count);
+			for(size_t i = 0; i < fields.count; ++i)
+			{
+				uint32_t id = flat_tkn(self, fields[i].id);
+				self.extra[record + 1 + i * 2] = id;
+				Flat_Ix expr = flat_ast_expr(self, fields[i].expr);
+				self.extra[record + 2 + i * 2] = expr;
+			}
+			return flat_node(self.types, atom.kind, FLAT_NIL, record, FLAT_NIL);
+		}
+
+		case Type_Atom::KIND_FUNC:
+		{
+			const auto& args = atom.func.args;
+			Flat_Ix record = flat_record(self, args.count + 1);
+			self.extra[record] = uint32_t(args.count);
+			for(size_t i = 0; i < args.count; ++i)
+			{
+				Flat_Ix arg = flat_type_sign(self, args[i]);
+				self.extra[record + 1 + i] = arg;
+			}
+			Flat_Ix ret = flat_type_sign(self, atom.func.ret);
+			return flat_node(self.types, atom.kind, FLAT_NIL, record, ret);
+		}
+
+		default:
+			assert(false && "unreachable");
+			return FLAT_NIL;
+		}
+	}
+
+	inline static Flat_Ix
+	flat_type_sign(Flat_AST& self, const Type_Sign& sign)
+	{
+		size_t count = type_sign_count(sign);
+		Flat_Ix record = flat_record(self, count + 1);
+		self.extra[record] = uint32_t(count);
+		for(size_t i = 0; i < count; ++i)
+		{
+			Flat_Ix atom = flat_type_atom(self, sign->atoms[i]);
+			self.extra[record + 1 + i] = atom;
+		}
+		return record;
+	}
+
+
+	//API
+	Flat_AST
+	flat_ast_new()
+	{
+		Flat_AST self{};
+		self.package = Tkn{};
+		self.tkns = mn::buf_new<Tkn>();
+		self.exprs = mn::buf_new<Flat_Node>();
+		self.stmts = mn::buf_new<Flat_Node>();
+		self.decls = mn::buf_new<Flat_Node>();
+		self.types = mn::buf_new<Flat_Node>();
+		self.extra = mn::buf_new<uint32_t>();
+		return self;
+	}
+
+	void
+	flat_ast_free(Flat_AST& self)
+	{
+		mn::buf_free(self.tkns);
+		mn::buf_free(self.exprs);
+		mn::buf_free(self.stmts);
+		mn::buf_free(self.decls);
+		mn::buf_free(self.types);
+		mn::buf_free(self.extra);
+	}
+
+	Flat_Ix
+	flat_ast_expr(Flat_AST& self, Expr* expr)
+	{
+		if(expr == nullptr)
+			return FLAT_NIL;
+
+		//children are flattened first so they come before their parents in the arrays
+		switch(expr->kind)
+		{
+		case Expr::KIND_ATOM:
+			return flat_node(self.exprs, expr->kind, flat_tkn(self, expr->atom), FLAT_NIL, FLAT_NIL);
+
+		case Expr::KIND_BINARY:
+		{
+			Flat_Ix lhs = flat_ast_expr(self, expr->binary.lhs);
+			Flat_Ix rhs = flat_ast_expr(self, expr->binary.rhs);
+			return flat_node(self.exprs, expr->kind, flat_tkn(self, expr->binary.op), lhs, rhs);
+		}
+
+		case Expr::KIND_UNARY:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->unary.expr);
+			return flat_node(self.exprs, expr->kind, flat_tkn(self, expr->unary.op), base, FLAT_NIL);
+		}
+
+		case Expr::KIND_DOT:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->dot.base);
+			return flat_node(self.exprs, expr->kind, flat_tkn(self, expr->dot.member), base, FLAT_NIL);
+		}
+
+		case Expr::KIND_INDEXED:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->indexed.base);
+			Flat_Ix index = flat_ast_expr(self, expr->indexed.index);
+			return flat_node(self.exprs, expr->kind, FLAT_NIL, base, index);
+		}
+
+		case Expr::KIND_CALL:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->call.base);
+			Flat_Ix args = flat_expr_list(self, expr->call.args);
+			return flat_node(self.exprs, expr->kind, FLAT_NIL, base, args);
+		}
+
+		case Expr::KIND_CAST:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->cast.base);
+			Flat_Ix type = flat_type_sign(self, expr->cast.type);
+			return flat_node(self.exprs, expr->kind, FLAT_NIL, base, type);
+		}
+
+		case Expr::KIND_PAREN:
+		{
+			Flat_Ix base = flat_ast_expr(self, expr->paren);
+			return flat_node(self.exprs, expr->kind, FLAT_NIL, base, FLAT_NIL);
+		}
+
+		case Expr::KIND_COMPLIT:
+		{
+			Flat_Ix type = flat_type_sign(self, expr->complit.type);
+			const auto& fields = expr->complit.fields;
+			Flat_Ix record = flat_record(self, fields.count * 3 + 1);
+			self.extra[record] = uint32_t(fields.count);
+			for(size_t i = 0; i < fields.count; ++i)
+			{
+				self.extra[record + 1 + i * 3] = uint32_t(fields[i].kind);
+				Flat_Ix left = flat_ast_expr(self, fields[i].left);
+				self.extra[record + 2 + i * 3] = left;
+				Flat_Ix right = flat_ast_expr(self, fields[i].right);
+				self.extra[record + 3 + i * 3] = right;
+			}
+			return flat_node(self.exprs, expr->kind, FLAT_NIL, type, record);
+		}
+
+		default:
+			assert(false && "unreachable");
+			return FLAT_NIL;
+		}
+	}
+
+	Flat_Ix
+	flat_ast_stmt(Flat_AST& self, Stmt* stmt)
+	{
+		if(stmt == nullptr)
+			return FLAT_NIL;
+
+		switch(stmt->kind)
+		{
+		case Stmt::KIND_BREAK:
+			return flat_node(self.stmts, stmt->kind, flat_tkn(self, stmt->break_stmt), FLAT_NIL, FLAT_NIL);
+
+		case Stmt::KIND_CONTINUE:
+			return flat_node(self.stmts, stmt->kind, flat_tkn(self, stmt->continue_stmt), FLAT_NIL, FLAT_NIL);
+
+		case Stmt::KIND_RETURN:
+		{
+			Flat_Ix expr = flat_ast_expr(self, stmt->return_stmt);
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, expr, FLAT_NIL);
+		}
+
+		case Stmt::KIND_IF:
+		{
+			Flat_Ix cond = flat_ast_expr(self, stmt->if_stmt.if_cond);
+			const auto& else_ifs = stmt->if_stmt.else_ifs;
+			Flat_Ix record = flat_record(self, else_ifs.count * 2 + 3);
+			Flat_Ix body = flat_ast_stmt(self, stmt->if_stmt.if_body);
+			self.extra[record] = body;
+			Flat_Ix else_body = flat_ast_stmt(self, stmt->if_stmt.else_body);
+			self.extra[record + 1] = else_body;
+			self.extra[record + 2] = uint32_t(else_ifs.count);
+			for(size_t i = 0; i < else_ifs.count; ++i)
+			{
+				Flat_Ix else_if_cond = flat_ast_expr(self, else_ifs[i].cond);
+				self.extra[record + 3 + i * 2] = else_if_cond;
+				Flat_Ix else_if_body = flat_ast_stmt(self, else_ifs[i].body);
+				self.extra[record + 4 + i * 2] = else_if_body;
+			}
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, cond, record);
+		}
+
+		case Stmt::KIND_FOR:
+		{
+			Flat_Ix record = flat_record(self, 4);
+			Flat_Ix init = flat_ast_stmt(self, stmt->for_stmt.init_stmt);
+			self.extra[record] = init;
+			Flat_Ix cond = flat_ast_expr(self, stmt->for_stmt.loop_cond);
+			self.extra[record + 1] = cond;
+			Flat_Ix post = flat_ast_stmt(self, stmt->for_stmt.post_stmt);
+			self.extra[record + 2] = post;
+			Flat_Ix body = flat_ast_stmt(self, stmt->for_stmt.loop_body);
+			self.extra[record + 3] = body;
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, record, FLAT_NIL);
+		}
+
+		case Stmt::KIND_VAR:
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, flat_var(self, stmt->var_stmt), FLAT_NIL);
+
+		case Stmt::KIND_ASSIGN:
+		{
+			Flat_Ix lhs = flat_expr_list(self, stmt->assign_stmt.lhs);
+			Flat_Ix rhs = flat_expr_list(self, stmt->assign_stmt.rhs);
+			return flat_node(self.stmts, stmt->kind, flat_tkn(self, stmt->assign_stmt.op), lhs, rhs);
+		}
+
+		case Stmt::KIND_EXPR:
+		{
+			Flat_Ix expr = flat_ast_expr(self, stmt->expr_stmt);
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, expr, FLAT_NIL);
+		}
+
+		case Stmt::KIND_BLOCK:
+		{
+			const auto& stmts = stmt->block_stmt;
+			Flat_Ix record = flat_record(self, stmts.count + 1);
+			self.extra[record] = uint32_t(stmts.count);
+			for(size_t i = 0; i < stmts.count; ++i)
+			{
+				Flat_Ix s = flat_ast_stmt(self, stmts[i]);
+				self.extra[record + 1 + i] = s;
+			}
+			return flat_node(self.stmts, stmt->kind, FLAT_NIL, record, FLAT_NIL);
+		}
+
+		default:
+			assert(false && "unreachable");
+			return FLAT_NIL;
+		}
+	}
+
+	Flat_Ix
+	flat_ast_decl(Flat_AST& self, Decl* decl)
+	{
+		switch(decl->kind)
+		{
+		case Decl::KIND_VAR:
+		{
+			Flat_Ix var = flat_var(self, decl->var_decl);
+			return flat_node(self.decls, decl->kind, flat_tkn(self, decl->name), var, FLAT_NIL);
+		}
+
+		case Decl::KIND_FUNC:
+		{
+			const auto& args = decl->func_decl.args;
+			Flat_Ix record = flat_record(self, args.count + 3);
+			Flat_Ix ret = flat_type_sign(self, decl->func_decl.ret_type);
+			self.extra[record] = ret;
+			Flat_Ix body = flat_ast_stmt(self, decl->func_decl.body);
+			self.extra[record + 1] = body;
+			self.extra[record + 2] = uint32_t(args.count);
+			for(size_t i = 0; i < args.count; ++i)
+			{
+				Flat_Ix arg = flat_field(self, args[i].ids, args[i].type);
+				self.extra[record + 3 + i] = arg;
+			}
+			return flat_node(self.decls, decl->kind, flat_tkn(self, decl->name), record, FLAT_NIL);
+		}
+
+		case Decl::KIND_TYPE:
+		{
+			Flat_Ix type = flat_type_sign(self, decl->type_decl);
+			return flat_node(self.decls, decl->kind, flat_tkn(self, decl->name), type, FLAT_NIL);
+		}
+
+		default:
+			assert(false && "unreachable");
+			return FLAT_NIL;
+		}
+	}
+
+	Flat_AST
+	flat_ast_from(const AST& ast)
+	{
+		auto self = flat_ast_new();
+		self.package = ast.package;
+		for(Decl* d: ast.decls)
+			flat_ast_decl(self, d);
+		return self;
+	}
+}
\ No newline at end of file
@@ -2,30 +2,82 @@
 
 #include <mn/Memory.h>
 #include <mn/IO.h>
+#include <mn/Thread.h>
 #include <mn/Defer.h>
 
+#include <assert.h>
+
+#include <thread>
+
 namespace zay
 {
 	inline static Field
 	parser_field(Parser& self);
 
-	inline static Expr*
-	parser_expr_base(Parser& self);
+	inline static void
+	parser_err(Parser& self, const Err& e)
+	{
+		if(self.errs)
+			mn::buf_push(*self.errs, e);
+		else
+			src_err(self.src, e);
+	}
+
+	// pulls the next token from the scanner or Src::tkns
+	inline static Tkn
+	parser_next_tkn(Parser& self)
+	{
+		if(self.streaming)
+			return scanner_tkn(&self.scanner);
+
+		//the parser reads Src::tkns in place, the comments are skipped using their kinds only so they're never decoded
+		const auto& kinds = self.src->tkns.kinds;
+		while(self.tkns_ix < self.tkns_end && kinds[self.tkns_ix] == Tkn::KIND_COMMENT)
+			self.tkns_ix++;
+
+		if(self.tkns_ix >= self.tkns_end)
+			return Tkn{};
+		const char* it = begin(self.src->content) + self.src->tkns.offsets[self.tkns_ix];
+		self.tkns_pos = pos_advance(self.tkns_pos, self.tkns_it, it);
+		self.tkns_it = it;
+		return src_tkn_at(self.src, self.tkns_ix++, self.tkns_pos);
+	}
+
+	// pulls tokens until token i is in the ring or there are no more tokens
+	inline static void
+	parser_pull(Parser& self, size_t i)
+	{
+		while(self.ring_end <= i)
+		{
+			Tkn tkn = parser_next_tkn(self);
+			if(tkn == false)
+				break;
+
+			//ignore the comments and other unwanted tokens coming from the scanner
+			if(tkn.kind == Tkn::KIND_COMMENT)
+				continue;
+
+			self.ring[self.ring_end % PARSER_RING_SIZE] = tkn;
+			self.ring_end++;
+		}
+	}
 
 	inline static Tkn
 	parser_last_tkn(Parser& self)
 	{
 		if(self.ix > 0)
-			return self.tkns[self.ix - 1];
-		return self.tkns[0];
+			return self.ring[(self.ix - 1) % PARSER_RING_SIZE];
+		return self.ring[0];
 	}
 
 	inline static Tkn
 	parser_look(Parser& self, size_t k)
 	{
-		if(self.ix + k >= self.tkns.count)
+		assert(k + 1 < PARSER_RING_SIZE && "look ahead is bigger than the parser ring");
+		parser_pull(self, self.ix + k);
+		if(self.ix + k >= self.ring_end)
 			return Tkn{};
-		return self.tkns[self.ix + k];
+		return self.ring[(self.ix + k) % PARSER_RING_SIZE];
 	}
 
 	inline static Tkn
@@ -46,9 +98,10 @@ namespace zay
 	inline static Tkn
 	parser_eat(Parser& self)
 	{
-		if(self.ix >= self.tkns.count)
-			return Tkn{};
-		return self.tkns[self.ix++];
+		Tkn t = parser_look(self);
+		if(t)
+			self.ix++;
+		return t;
 	}
 
 	inline static Tkn
@@ -63,10 +116,10 @@ namespace zay
 	inline static Tkn
 	parser_eat_must(Parser& self, Tkn::KIND kind)
 	{
-		if(self.ix >= self.tkns.count)
+		if(parser_eof(self))
 		{
-			src_err(
-				self.src,
+			parser_err(
+				self,
 				err_str(mn::strf("expected '{}' but found EOF", Tkn::NAMES[kind]))
 			);
 			return Tkn{};
@@ -76,8 +129,8 @@ namespace zay
 		if(tkn.kind == kind)
 			return tkn;
 
-		src_err(
-			self.src,
+		parser_err(
+			self,
 			err_tkn(tkn, mn::strf("expected '{}' but found '{}'", Tkn::NAMES[kind], tkn.str))
 		);
 		return Tkn{};
@@ -105,9 +158,21 @@ namespace zay
 		}
 		else if(t.kind == Tkn::KIND_ID)
 		{
-			for (size_t i = 0; i < self.typenames.count; ++i)
-				if (self.typenames[i].str == t.str)
-					return true;
+			if(ast_typename_has(self.src->ast, t.str))
+				return true;
+
+			//the typename might be declared later so remember which declaration didn't know it
+			if(self.typename_misses)
+			{
+				auto& misses = *self.typename_misses;
+				size_t decl_ix = self.src->ast.decls.count;
+				if (misses.count == 0 ||
+					misses[misses.count - 1].name != t.str ||
+					misses[misses.count - 1].decl_ix != decl_ix)
+				{
+					mn::buf_push(misses, Typename_Miss{t.str, decl_ix});
+				}
+			}
 		}
 		return false;
 	}
@@ -115,7 +180,7 @@ namespace zay
 	inline static Type_Sign
 	parser_type(Parser& self)
 	{
-		Type_Sign type = type_sign_new();
+		auto type = mn::buf_new<Type_Atom>();
 		while(true)
 		{
 			Tkn tkn = parser_look(self);
@@ -137,8 +202,8 @@ namespace zay
 			{
 				if (parser_is_type(self, tkn) == false)
 				{
-					src_err(
-						self.src,
+					parser_err(
+						self,
 						err_tkn(tkn, mn::strf("'{}' is not a type", tkn.str))
 					);
 				}
@@ -209,7 +274,7 @@ namespace zay
 					}
 				} while (parser_eat_kind(self, Tkn::KIND_COMMA));
 				parser_eat_must(self, Tkn::KIND_CLOSE_PAREN);
-				Type_Sign ret = type_sign_new();
+				Type_Sign ret = nullptr;
 				if (parser_eat_kind(self, Tkn::KIND_COLON))
 					ret = parser_type(self);
 				mn::buf_push(type, type_atom_func(args, ret));
@@ -232,7 +297,7 @@ namespace zay
 				break;
 			}
 		}
-		return type;
+		return type_sign_from(self.src->ast.signs, type);
 	}
 
 	inline static Field
@@ -243,7 +308,7 @@ namespace zay
 		do
 		{
 			if(Tkn id = parser_eat_kind(self, Tkn::KIND_ID))
-				mn::buf_push(field.ids, id);
+				small_buf_push(field.ids, id);
 		}while(parser_eat_kind(self, Tkn::KIND_COMMA));
 
 		parser_eat_must(self, Tkn::KIND_COLON);
@@ -257,6 +322,9 @@ namespace zay
 		//only working with struct, and enums
 		parser_eat_must(self, Tkn::KIND_KEYWORD_TYPE);
 		Tkn id = parser_eat_must(self, Tkn::KIND_ID);
+		//it's added before parsing the type so the type can refer to itself
+		if(self.typename_misses && id && ast_typename_has(self.src->ast, id.str) == false)
+			ast_typename_add(self.src->ast, id);
 		return decl_type(id, parser_type(self));
 	}
 
@@ -269,7 +337,7 @@ namespace zay
 		do
 		{
 			if(Tkn id = parser_eat_must(self, Tkn::KIND_ID))
-				mn::buf_push(v.ids, id);
+				small_buf_push(v.ids, id);
 		}while(parser_eat_kind(self, Tkn::KIND_COMMA));
 
 		if(parser_eat_kind(self, Tkn::KIND_COLON))
@@ -300,7 +368,7 @@ namespace zay
 		do
 		{
 			if(Tkn id = parser_eat_kind(self, Tkn::KIND_ID))
-				mn::buf_push(arg.ids, id);
+				small_buf_push(arg.ids, id);
 		}while(parser_eat_kind(self, Tkn::KIND_COMMA));
 
 		//function arguments must have a type
@@ -312,6 +380,64 @@ namespace zay
 	inline static Stmt*
 	parser_stmt_block(Parser& self);
 
+	// skips the block which begins at the current { by matching the braces, the stored tokens are skipped without
+	// decoding them, if the block isn't closed it returns false and doesn't move so the parser reports the error
+	inline static bool
+	parser_body_skip(Parser& self)
+	{
+		if(self.streaming)
+		{
+			//the scanner has to go through the tokens anyway, we only skip building the nodes
+			//and since they can't be pulled again an unclosed block is reported here
+			Tkn open = parser_eat(self);
+			size_t depth = 1;
+			while(depth > 0)
+			{
+				Tkn tkn = parser_eat(self);
+				if(tkn.kind == Tkn::KIND_OPEN_CURLY)
+				{
+					depth++;
+				}
+				else if(tkn.kind == Tkn::KIND_CLOSE_CURLY)
+				{
+					depth--;
+				}
+				else if(tkn == false)
+				{
+					parser_err(self, err_tkn(open, mn::strf("'{{' is not closed")));
+					break;
+				}
+			}
+			return true;
+		}
+
+		const auto& kinds = self.src->tkns.kinds;
+		Tkn open = parser_look(self);
+		size_t first = tkn_store_lower_bound(self.src->tkns, size_t(open.rng.begin - begin(self.src->content)));
+		size_t depth = 0;
+		for(size_t i = first; i < self.tkns_end; ++i)
+		{
+			if(kinds[i] == Tkn::KIND_OPEN_CURLY)
+			{
+				depth++;
+			}
+			else if(kinds[i] == Tkn::KIND_CLOSE_CURLY && --depth == 0)
+			{
+				//the } becomes the last eaten token and the look ahead is dropped, the next pull is right after it
+				//the look ahead might be past the } so its position is counted from the {
+				const char* it = begin(self.src->content) + self.src->tkns.offsets[i];
+				self.tkns_pos = pos_advance(open.pos, open.rng.begin, it);
+				self.tkns_it = it;
+				self.ring[self.ix % PARSER_RING_SIZE] = src_tkn_at(self.src, i, self.tkns_pos);
+				self.ix++;
+				self.ring_end = self.ix;
+				self.tkns_ix = i + 1;
+				return true;
+			}
+		}
+		return false;
+	}
+
 	inline static Decl*
 	parser_decl_func(Parser& self)
 	{
@@ -331,55 +457,75 @@ namespace zay
 		parser_eat_must(self, Tkn::KIND_CLOSE_PAREN);
 
 		//wait the return type ...
-		Type_Sign ret_type = type_sign_new();
+		Type_Sign ret_type = nullptr;
 		if(parser_eat_kind(self, Tkn::KIND_COLON))
 			ret_type = parser_type(self);
 
 		//now that we have argument list we need to parse the body if it exists
 		Stmt* body = nullptr;
-		if(parser_look_kind(self, Tkn::KIND_OPEN_CURLY))
+		Tkn open = parser_look_kind(self, Tkn::KIND_OPEN_CURLY);
+		if(open && self.src->bodies == BODIES::LAZY && parser_body_skip(self))
+		{
+			Decl* decl = decl_func(name, args, ret_type, body);
+			decl->func_decl.lazy_body_open = open;
+			return decl;
+		}
+
+		if(open)
 			body = parser_stmt_block(self);
 		return decl_func(name, args, ret_type, body);
 	}
 
 
-	inline static bool
-	is_cmp_op(const Tkn& t)
+	// binary operators precedence from the loosest to the tightest binding, 0 is not a binary operator
+	enum PREC: uint8_t
 	{
-		return (
-			t.kind == Tkn::KIND_LESS ||
-			t.kind == Tkn::KIND_GREATER ||
-			t.kind == Tkn::KIND_LESS_EQUAL ||
-			t.kind == Tkn::KIND_GREATER_EQUAL ||
-			t.kind == Tkn::KIND_EQUAL_EQUAL ||
-			t.kind == Tkn::KIND_NOT_EQUAL
-		);
-	}
-
-	inline static bool
-	is_add_op(const Tkn& t)
+		PREC_NONE,
+		PREC_LOGIC_OR,
+		PREC_LOGIC_AND,
+		// comparisons don't chain, a < b < c is an error
+		PREC_CMP,
+		PREC_ADD,
+		PREC_MUL
+	};
+
+	struct Binary_Op_Table
 	{
-		return (
-			t.kind == Tkn::KIND_PLUS ||
-			t.kind == Tkn::KIND_MINUS ||
-			t.kind == Tkn::KIND_BIT_XOR ||
-			t.kind == Tkn::KIND_BIT_OR
-		);
-	}
+		uint8_t precs[Tkn::KIND_KEYWORDS__END + 1];
+	};
 
-	inline static bool
-	is_mul_op(const Tkn& t)
+	constexpr Binary_Op_Table
+	binary_op_table_build()
 	{
-		return (
-			t.kind == Tkn::KIND_STAR ||
-			t.kind == Tkn::KIND_DIV ||
-			t.kind == Tkn::KIND_MOD ||
-			t.kind == Tkn::KIND_BIT_AND ||
-			t.kind == Tkn::KIND_LEFT_SHIFT ||
-			t.kind == Tkn::KIND_RIGHT_SHIFT
-		);
+		Binary_Op_Table self{};
+		self.precs[Tkn::KIND_LOGIC_OR] = PREC_LOGIC_OR;
+
+		self.precs[Tkn::KIND_LOGIC_AND] = PREC_LOGIC_AND;
+
+		self.precs[Tkn::KIND_LESS] = PREC_CMP;
+		self.precs[Tkn::KIND_GREATER] = PREC_CMP;
+		self.precs[Tkn::KIND_LESS_EQUAL] = PREC_CMP;
+		self.precs[Tkn::KIND_GREATER_EQUAL] = PREC_CMP;
+		self.precs[Tkn::KIND_EQUAL_EQUAL] = PREC_CMP;
+		self.precs[Tkn::KIND_NOT_EQUAL] = PREC_CMP;
+
+		self.precs[Tkn::KIND_PLUS] = PREC_ADD;
+		self.precs[Tkn::KIND_MINUS] = PREC_ADD;
+		self.precs[Tkn::KIND_BIT_XOR] = PREC_ADD;
+		self.precs[Tkn::KIND_BIT_OR] = PREC_ADD;
+
+		self.precs[Tkn::KIND_STAR] = PREC_MUL;
+		self.precs[Tkn::KIND_DIV] = PREC_MUL;
+		self.precs[Tkn::KIND_MOD] = PREC_MUL;
+		self.precs[Tkn::KIND_BIT_AND] = PREC_MUL;
+		self.precs[Tkn::KIND_LEFT_SHIFT] = PREC_MUL;
+		self.precs[Tkn::KIND_RIGHT_SHIFT] = PREC_MUL;
+		return self;
 	}
 
+	// one lookup per token decides whether it continues the binary expression and how tight it binds
+	constexpr Binary_Op_Table BINARY_OPS = binary_op_table_build();
+
 	inline static bool
 	is_unary_op(const Tkn& t)
 	{
@@ -420,7 +566,7 @@ namespace zay
 			}
 			else
 			{
-				src_err(self.src, err_tkn(tkn, mn::strf("'{}' unknown field in composite literal", tkn.str)));
+				parser_err(self, err_tkn(tkn, mn::strf("'{}' unknown field in composite literal", tkn.str)));
 				break;
 			}
 			parser_eat_must(self, Tkn::KIND_COLON);
@@ -452,7 +598,8 @@ namespace zay
 		}
 		else if(tkn.kind == Tkn::KIND_ID)
 		{
-			if (parser_is_type(self, tkn) && parser_look(self, 1).kind == Tkn::KIND_OPEN_CURLY)
+			//the type check comes second so only the ids which could begin a complit count as typename misses
+			if (parser_look(self, 1).kind == Tkn::KIND_OPEN_CURLY && parser_is_type(self, tkn))
 				expr = parser_expr_complit(self);
 			else
 				expr = expr_atom(parser_eat(self));
@@ -465,13 +612,6 @@ namespace zay
 		{
 			expr = expr_atom(parser_eat(self));
 		}
-		else if(tkn.kind == Tkn::KIND_OPEN_PAREN)
-		{
-			parser_eat(self); // for the (
-			expr = parser_expr(self);
-			parser_eat_must(self, Tkn::KIND_CLOSE_PAREN);
-			expr = expr_paren(expr);
-		}
 		else if(tkn.kind == Tkn::KIND_KEYWORD_STRUCT ||
 				tkn.kind == Tkn::KIND_KEYWORD_UNION ||
 				tkn.kind == Tkn::KIND_KEYWORD_ENUM ||
@@ -503,30 +643,29 @@ namespace zay
 		}
 		else
 		{
-			src_err(
-				self.src,
+			parser_err(
+				self,
 				err_tkn(tkn, mn::strf("expected an expression but found '{}'", Tkn::NAMES[tkn.kind]))
 			);
 		}
 		return expr;
 	}
 
+	// applies the calls, indexing and member access which follow the expr, begin is the first token of it
 	inline static Expr*
-	parser_expr_base(Parser& self)
+	parser_expr_postfix(Parser& self, Expr* expr, const Tkn& begin)
 	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_atom(self);
 		while(true)
 		{
 			Tkn tkn = parser_look(self);
 			if(tkn.kind == Tkn::KIND_OPEN_PAREN)
 			{
 				parser_eat(self); //for the (
-				auto args = mn::buf_new<Expr*>();
+				auto args = small_buf_new<Call_Args>();
 				do
 				{
 					if(Expr* arg = parser_expr(self))
-						mn::buf_push(args, arg);
+						small_buf_push(args, arg);
 				}while(parser_eat_kind(self, Tkn::KIND_COMMA));
 				parser_eat_must(self, Tkn::KIND_CLOSE_PAREN);
 				expr = expr_call(expr, args);
@@ -551,146 +690,63 @@ namespace zay
 
 		if(expr)
 		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
-	}
-
-	inline static Expr*
-	parser_expr_unary(Parser& self)
-	{
-		Tkn t = parser_look(self);
-		Expr* expr = nullptr;
-		if(is_unary_op(parser_look(self)))
-		{
-			Tkn op = parser_eat(self);
-			expr = expr_unary(op, parser_expr_unary(self));
-		}
-		else
-		{
-			expr = parser_expr_base(self);
-		}
-
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
-	}
-
-	inline static Expr*
-	parser_expr_cast(Parser& self)
-	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_unary(self);
-		if(parser_eat_kind(self, Tkn::KIND_COLON))
-			expr = expr_cast(expr, parser_type(self));
-
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
+			expr->rng = Rng{ begin.rng.begin, parser_last_tkn(self).rng.end };
+			expr->pos = begin.pos;
 		}
 
 		return expr;
 	}
 
-	inline static Expr*
-	parser_expr_mul(Parser& self)
+	// a part of an expr which waits for the operand after it, the open parens, the unary operators and the
+	// binary operators with their lhs
+	struct Parse_Expr_Frame
 	{
-		Tkn t = parser_look(self);
-
-		Expr* expr = parser_expr_cast(self);
-		while(is_mul_op(parser_look(self)))
+		enum KIND
 		{
-			Tkn op = parser_eat(self);
-			expr = expr_binary(expr, op, parser_expr_cast(self));
-		}
+			KIND_PAREN,
+			KIND_UNARY,
+			KIND_BINARY
+		};
+
+		KIND kind;
+		// the open paren, the unary operator or the binary operator
+		Tkn tkn;
+		// first token of the lhs of a binary operator
+		Tkn begin;
+		Expr* lhs;
+	};
+
+	// most exprs nest a few levels, the deeper ones move the stack to the heap
+	typedef Small_Buf<Parse_Expr_Frame, 8> Parse_Expr_Stack;
 
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
-	}
-
-	inline static Expr*
-	parser_expr_add(Parser& self)
-	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_mul(self);
-		while(is_add_op(parser_look(self)))
-		{
-			Tkn op = parser_eat(self);
-			expr = expr_binary(expr, op, parser_expr_mul(self));
-		}
-
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
-	}
-
-	inline static Expr*
-	parser_expr_cmp(Parser& self)
+	inline static bool
+	parse_expr_stack_top_is(const Parse_Expr_Stack& stack, Parse_Expr_Frame::KIND kind)
 	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_add(self);
-		if(is_cmp_op(parser_look(self)))
-		{
-			Tkn op = parser_eat(self);
-			expr = expr_binary(expr, op, parser_expr_add(self));
-		}
-
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
+		return stack.count > 0 && stack[stack.count - 1].kind == kind;
 	}
 
-	inline static Expr*
-	parser_expr_and(Parser& self)
+	inline static Parse_Expr_Frame
+	parse_expr_stack_pop(Parse_Expr_Stack& stack)
 	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_cmp(self);
-		while(Tkn tkn = parser_eat_kind(self, Tkn::KIND_LOGIC_AND))
-			expr = expr_binary(expr, tkn, parser_expr_cmp(self));
-
-		if(expr)
-		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
-		}
-
-		return expr;
+		Parse_Expr_Frame res = stack[stack.count - 1];
+		--stack.count;
+		return res;
 	}
 
+	// folds the pending binary operators which bind at least as tight as prec into expr, begin becomes the
+	// first token of the folded expr
 	inline static Expr*
-	parser_expr_or(Parser& self)
+	parser_expr_binary_fold(Parser& self, Parse_Expr_Stack& stack, Expr* expr, uint8_t prec, Tkn& begin)
 	{
-		Tkn t = parser_look(self);
-		Expr* expr = parser_expr_and(self);
-		while(Tkn tkn = parser_eat_kind(self, Tkn::KIND_LOGIC_OR))
-			expr = expr_binary(expr, tkn, parser_expr_and(self));
-
-		if(expr)
+		while (parse_expr_stack_top_is(stack, Parse_Expr_Frame::KIND_BINARY) &&
+			BINARY_OPS.precs[stack[stack.count - 1].tkn.kind] >= prec)
 		{
-			expr->rng = Rng{ t.rng.begin, parser_last_tkn(self).rng.end };
-			expr->pos = t.pos;
+			Parse_Expr_Frame frame = parse_expr_stack_pop(stack);
+			expr = expr_binary(frame.lhs, frame.tkn, expr);
+			expr->rng = Rng{ frame.begin.rng.begin, parser_last_tkn(self).rng.end };
+			expr->pos = frame.begin.pos;
+			begin = frame.begin;
 		}
-
 		return expr;
 	}
 
@@ -713,59 +769,48 @@ namespace zay
 		);
 	}
 
-	inline static Stmt*
-	parser_stmt_block(Parser& self)
+	// a block which is being parsed, it's either a block stmt or the body of an if or a for stmt
+	struct Parse_Block
 	{
-		parser_eat_must(self, Tkn::KIND_OPEN_CURLY);
-
-		auto stmts = mn::buf_new<Stmt*>();
-		while(parser_look_kind(self, Tkn::KIND_CLOSE_CURLY) == false)
-			mn::buf_push(stmts, parser_stmt(self));
-
-		parser_eat_must(self, Tkn::KIND_CLOSE_CURLY);
-		return stmt_block(stmts);
-	}
-
-	inline static Stmt*
-	parser_stmt_if(Parser& self)
-	{
-		parser_eat_must(self, Tkn::KIND_KEYWORD_IF);
-		Expr* if_cond = parser_expr(self);
-		Stmt* if_body = parser_stmt_block(self);
-		Stmt* else_body = nullptr;
-		auto else_ifs = mn::buf_new<Else_If>();
-		while(parser_eat_kind(self, Tkn::KIND_KEYWORD_ELSE))
+		enum KIND
 		{
-			if(parser_eat_kind(self, Tkn::KIND_KEYWORD_IF))
-			{
-				Expr* cond = parser_expr(self);
-				Stmt* body = parser_stmt_block(self);
-				mn::buf_push(else_ifs, Else_If{cond, body});
-			}
-			else
-			{
-				else_body = parser_stmt_block(self);
-				break;
-			}
-		}
-
-		return stmt_if(if_cond, if_body, else_ifs, else_body);
+			KIND_BLOCK,
+			KIND_IF_BODY,
+			KIND_ELSE_IF_BODY,
+			KIND_ELSE_BODY,
+			KIND_FOR_BODY
+		};
+
+		KIND kind;
+		// the if or for stmt the block is the body of
+		Stmt* owner;
+		// first token of the stmt, its range is set once it's done
+		Tkn begin;
+		mn::Buf<Stmt*> stmts;
+	};
+
+	inline static void
+	parser_block_open(Parser& self, mn::Buf<Parse_Block>& blocks, Parse_Block::KIND kind, Stmt* owner, const Tkn& begin)
+	{
+		parser_eat_must(self, Tkn::KIND_OPEN_CURLY);
+		mn::buf_push(blocks, Parse_Block{kind, owner, begin, mn::buf_new<Stmt*>()});
 	}
 
+	// parses the for stmt up to its body, has_body is set if a block follows it
 	inline static Stmt*
-	parser_stmt_for(Parser& self)
+	parser_stmt_for_head(Parser& self, bool& has_body)
 	{
 		parser_eat_must(self, Tkn::KIND_KEYWORD_FOR);
 
 		Stmt* init_stmt = nullptr;
 		Expr* loop_cond = nullptr;
 		Stmt* post_stmt = nullptr;
-		Stmt* loop_body = nullptr;
+		has_body = true;
 
 		//for {}
 		if(parser_look_kind(self, Tkn::KIND_OPEN_CURLY))
 		{
-			loop_body = parser_stmt_block(self);
+			return stmt_for(init_stmt, loop_cond, post_stmt, nullptr);
 		}
 		//for ;cond;post {}
 		else if(parser_eat_kind(self, Tkn::KIND_SEMICOLON))
@@ -774,7 +819,6 @@ namespace zay
 			parser_eat_must(self, Tkn::KIND_SEMICOLON);
 			if(parser_look_kind(self, Tkn::KIND_OPEN_CURLY) == false)
 				post_stmt = parser_stmt(self);
-			loop_body = parser_stmt_block(self);
 		}
 		//for cond {}
 		//for init_stmt;loop_cond;post_stmt{}
@@ -787,17 +831,19 @@ namespace zay
 				parser_eat_must(self, Tkn::KIND_SEMICOLON);
 				if(parser_look_kind(self, Tkn::KIND_OPEN_CURLY) == false)
 					post_stmt = parser_stmt(self);
-				loop_body = parser_stmt_block(self);
 			}
 			else if(parser_look_kind(self, Tkn::KIND_OPEN_CURLY))
 			{
 				loop_cond = stmt_expr_decay(init_stmt);
 				init_stmt = nullptr;
-				loop_body = parser_stmt_block(self);
+			}
+			else
+			{
+				has_body = false;
 			}
 		}
 
-		return stmt_for(init_stmt, loop_cond, post_stmt, loop_body);
+		return stmt_for(init_stmt, loop_cond, post_stmt, nullptr);
 	}
 
 	inline static Stmt*
@@ -833,8 +879,8 @@ namespace zay
 		//this is not an assign stmt so it must be an expression stmt
 		if(lhs.count > 1)
 		{
-			src_err(
-				self.src,
+			parser_err(
+				self,
 				err_str(mn::strf("can't have multiple expression in the same statements"))
 			);
 		}
@@ -845,43 +891,319 @@ namespace zay
 	}
 
 
+	// stores with fewer tokens than this are parsed sequentially, it's also the smallest slice size
+	constexpr size_t PARSE_SLICE_MIN_COUNT = 64 * 1024;
+
+	// a run of top level declarations parsed on its own thread into its own arena
+	struct Parse_Slice
+	{
+		Parser parser;
+		mn::Allocator arena;
+		mn::Buf<Decl*> decls;
+		mn::Buf<Err> errs;
+		// the first slice parses the package declaration
+		bool has_package;
+		Tkn package;
+		// the parser met a token which doesn't begin a declaration, the sequential parse stops there
+		bool stopped;
+	};
+
+	inline static void
+	parse_slice_worker(void* arg)
+	{
+		auto self = (Parse_Slice*)arg;
+		mn::allocator_push(self->arena);
+
+		if(self->has_package)
+			self->package = parser_pkg(self->parser);
+
+		while(parser_eof(self->parser) == false)
+		{
+			if(Decl* d = parser_decl(self->parser))
+			{
+				mn::buf_push(self->decls, d);
+			}
+			else
+			{
+				self->stopped = true;
+				break;
+			}
+		}
+
+		mn::allocator_pop();
+	}
+
+	// whether token i begins a top level declaration assuming it's not inside any brackets, a func keyword
+	// followed by anything other than a name is a function type like the ones in var declarations
+	inline static bool
+	parse_decl_begins(const mn::Buf<uint8_t>& kinds, size_t i)
+	{
+		if(kinds[i] == Tkn::KIND_KEYWORD_TYPE || kinds[i] == Tkn::KIND_KEYWORD_VAR)
+			return true;
+		if(kinds[i] != Tkn::KIND_KEYWORD_FUNC)
+			return false;
+
+		for(size_t j = i + 1; j < kinds.count; ++j)
+			if(kinds[j] != Tkn::KIND_COMMENT)
+				return kinds[j] == Tkn::KIND_ID;
+		return false;
+	}
+
+	inline static void
+	parse_slice_free(Parse_Slice& self)
+	{
+		//the error messages are in the arena
+		mn::buf_free(self.errs);
+		mn::buf_free(self.decls);
+		mn::allocator_free(self.arena);
+	}
+
+	// where a top level declaration of a streaming parse begins
+	struct Parse_Mark
+	{
+		const char* it;
+		Pos pos;
+		// Src::errs count before parsing the declaration
+		size_t errs_count;
+	};
+
+	// moves the streaming parser back to the beginning of the given declaration and drops everything
+	// parsed from there, the comments before the declaration were already recorded so they're kept
+	inline static void
+	parser_stream_rewind(Parser& self, mn::Buf<Parse_Mark>& marks, size_t decl_ix)
+	{
+		Src* src = self.src;
+		Parse_Mark mark = marks[decl_ix];
+
+		for(size_t i = mark.errs_count; i < src->errs.count; ++i)
+			destruct(src->errs[i]);
+		mn::buf_resize(src->errs, mark.errs_count);
+
+		auto& trivia = src->tkns.trivia;
+		size_t offset = size_t(mark.it - begin(src->content));
+		while(trivia.count > 0 && trivia[trivia.count - 1].offset >= offset)
+			mn::buf_pop(trivia);
+		auto& values = src->tkns.values;
+		while(values.count > 0 && values[values.count - 1].offset >= offset)
+			mn::buf_pop(values);
+
+		//the dropped decls stay in the arena until the AST is freed
+		mn::buf_resize(src->ast.decls, decl_ix);
+		mn::buf_resize(marks, decl_ix);
+		auto& misses = *self.typename_misses;
+		while(misses.count > 0 && misses[misses.count - 1].decl_ix >= decl_ix)
+			mn::buf_pop(misses);
+
+		self.scanner.it = mark.it;
+		self.scanner.c = mn::rune_read(mark.it);
+		self.scanner.pos = mark.pos;
+		self.scanner.col_it = mark.it;
+		self.ix = 0;
+		self.ring_end = 0;
+	}
+
+	// pulls the rest of the tokens to learn the typenames declared after the point where the parse stopped
+	inline static void
+	parser_stream_learn_typenames(Parser& self)
+	{
+		while(parser_eof(self) == false)
+		{
+			Tkn tkn = parser_eat(self);
+			if(tkn.kind != Tkn::KIND_KEYWORD_TYPE)
+				continue;
+			Tkn id = parser_look_kind(self, Tkn::KIND_ID);
+			if(id && ast_typename_has(self.src->ast, id.str) == false)
+				ast_typename_add(self.src->ast, id);
+		}
+	}
+
 	//API
 	Parser
 	parser_new(Src *src)
 	{
 		Parser self{};
 		self.src = src;
-		self.tkns = clone(src->tkns);
 		self.ix = 0;
-		self.typenames = mn::buf_new<Tkn>();
-		//ignore the comments and other unwanted tokens for parsing
-		buf_remove_if(self.tkns, [](const Tkn& t) {
-			return t.kind == Tkn::KIND_COMMENT;
-		});
-		for (size_t i = 0; i < self.tkns.count; ++i)
+		self.streaming = false;
+		self.tkns_ix = 0;
+		self.tkns_end = tkn_store_count(src->tkns);
+		self.tkns_it = begin(src->content);
+		self.tkns_pos = Pos{1, 0};
+		self.errs = nullptr;
+		self.typename_misses = nullptr;
+		self.ring_end = 0;
+
+		//the kinds are enough to find the typenames, the token after the type keyword is the only one we decode
+		mn::buf_clear(src->ast.typenames);
+		mn::buf_clear(src->ast.typenames_set);
+		//the typenames are in order so their positions are counted from the previous one
+		const auto& kinds = src->tkns.kinds;
+		const char* typename_it = begin(src->content);
+		Pos typename_pos{1, 0};
+		for (size_t i = 0; i < kinds.count; ++i)
 		{
-			if (self.tkns[i].kind == Tkn::KIND_KEYWORD_TYPE && i < self.tkns.count)
-				mn::buf_push(self.typenames, self.tkns[i + 1]);
+			if (kinds[i] != Tkn::KIND_KEYWORD_TYPE)
+				continue;
+
+			for (size_t j = i + 1; j < kinds.count; ++j)
+			{
+				if (kinds[j] == Tkn::KIND_COMMENT)
+					continue;
+				const char* it = begin(src->content) + src->tkns.offsets[j];
+				typename_pos = pos_advance(typename_pos, typename_it, it);
+				typename_it = it;
+				ast_typename_add(src->ast, src_tkn_at(src, j, typename_pos));
+				break;
+			}
 		}
 
 		return self;
 	}
 
-	void
-	parser_free(Parser& self)
+	Parser
+	parser_stream_new(Src *src)
+	{
+		Parser self{};
+		self.src = src;
+		self.ix = 0;
+		self.streaming = true;
+		self.scanner = scanner_new(src);
+		self.errs = nullptr;
+		self.typename_misses = nullptr;
+		self.ring_end = 0;
+
+		src_validate_utf8(src);
+		return self;
+	}
+
+	bool
+	parser_eof(Parser& self)
+	{
+		return parser_look(self) == false;
+	}
+
+	bool
+	src_parse_func_body(Src *src, Decl* decl)
 	{
-		mn::buf_free(self.tkns);
-		mn::buf_free(self.typenames);
+		assert(decl->kind == Decl::KIND_FUNC);
+		auto& func = decl->func_decl;
+		if(func.lazy_body_open == false)
+			return true;
+
+		Parser self{};
+		self.src = src;
+		self.ix = 0;
+		self.errs = nullptr;
+		self.ring_end = 0;
+		if(tkn_store_count(src->tkns) > 0)
+		{
+			self.streaming = false;
+			self.tkns_end = tkn_store_count(src->tkns);
+			self.tkns_ix = tkn_store_lower_bound(src->tkns, size_t(func.lazy_body_open.rng.begin - begin(src->content)));
+			self.tkns_it = func.lazy_body_open.rng.begin;
+			self.tkns_pos = func.lazy_body_open.pos;
+		}
+		else
+		{
+			//the src was parsed while scanning, so scan the body again, its comments and literal values were
+			//already recorded and so were its scan errors but the typer doesn't run on srcs with errors
+			self.streaming = true;
+			self.scanner = scanner_new(src);
+			self.scanner.it = func.lazy_body_open.rng.begin;
+			self.scanner.c = mn::rune_read(self.scanner.it);
+			self.scanner.pos = func.lazy_body_open.pos;
+			self.scanner.col_it = self.scanner.it;
+			self.scanner.trivia = nullptr;
+			self.scanner.values = nullptr;
+		}
+
+		size_t errs_count = src->errs.count;
+		mn::allocator_push(src->ast.arena);
+		func.body = parser_stmt_block(self);
+		mn::allocator_pop();
+
+		func.lazy_body_open = Tkn{};
+		return src->errs.count == errs_count;
 	}
 
+	// operator precedence parsing over BINARY_OPS where the pending operators and parens are kept on an
+	// explicit stack, so neither long chains nor deep nesting grow the call stack
 	Expr*
 	parser_expr(Parser& self)
 	{
-		return parser_expr_or(self);
+		auto stack = small_buf_new<Parse_Expr_Stack>(mn::memory::clib());
+		mn_defer(small_buf_free(stack));
+
+		while(true)
+		{
+			//the open parens and unary operators before the operand wait for it on the stack
+			Tkn tkn = parser_look(self);
+			while(is_unary_op(tkn) || tkn.kind == Tkn::KIND_OPEN_PAREN)
+			{
+				auto kind = tkn.kind == Tkn::KIND_OPEN_PAREN ? Parse_Expr_Frame::KIND_PAREN : Parse_Expr_Frame::KIND_UNARY;
+				small_buf_push(stack, Parse_Expr_Frame{kind, parser_eat(self), tkn, nullptr});
+				tkn = parser_look(self);
+			}
+
+			Tkn begin = tkn;
+			Expr* expr = parser_expr_postfix(self, parser_expr_atom(self), begin);
+			while(true)
+			{
+				while(parse_expr_stack_top_is(stack, Parse_Expr_Frame::KIND_UNARY))
+				{
+					Parse_Expr_Frame frame = parse_expr_stack_pop(stack);
+					expr = expr_unary(frame.tkn, expr);
+					expr->rng = Rng{ frame.tkn.rng.begin, parser_last_tkn(self).rng.end };
+					expr->pos = frame.tkn.pos;
+					begin = frame.tkn;
+				}
+
+				if(parser_eat_kind(self, Tkn::KIND_COLON))
+					expr = expr_cast(expr, parser_type(self));
+
+				if(expr)
+				{
+					expr->rng = Rng{ begin.rng.begin, parser_last_tkn(self).rng.end };
+					expr->pos = begin.pos;
+				}
+
+				Tkn op = parser_look(self);
+				uint8_t prec = BINARY_OPS.precs[op.kind];
+				expr = parser_expr_binary_fold(self, stack, expr, prec, begin);
+
+				//comparisons don't chain so the expr ends here like it does for any non binary operator
+				if (prec == PREC_CMP &&
+					expr &&
+					expr->kind == Expr::KIND_BINARY &&
+					BINARY_OPS.precs[expr->binary.op.kind] == PREC_CMP)
+				{
+					prec = PREC_NONE;
+					expr = parser_expr_binary_fold(self, stack, expr, prec, begin);
+				}
+
+				if(prec != PREC_NONE)
+				{
+					small_buf_push(stack, Parse_Expr_Frame{Parse_Expr_Frame::KIND_BINARY, parser_eat(self), begin, expr});
+					break;
+				}
+
+				if(stack.count == 0)
+					return expr;
+
+				//the operand of the open paren is done so the paren is an operand of what's before it
+				Parse_Expr_Frame frame = parse_expr_stack_pop(stack);
+				assert(frame.kind == Parse_Expr_Frame::KIND_PAREN);
+				parser_eat_must(self, Tkn::KIND_CLOSE_PAREN);
+				begin = frame.tkn;
+				expr = parser_expr_postfix(self, expr_paren(expr), begin);
+			}
+		}
 	}
 
-	Stmt*
-	parser_stmt(Parser& self)
+	// begins the stmt at the current token, the ones with blocks open their first block and return nullptr
+	// the others are parsed and returned
+	inline static Stmt*
+	parser_stmt_begin(Parser& self, mn::Buf<Parse_Block>& blocks)
 	{
 		Tkn tkn = parser_look(self);
 		Stmt* res = nullptr;
@@ -901,15 +1223,26 @@ namespace zay
 		}
 		else if(tkn.kind == Tkn::KIND_OPEN_CURLY)
 		{
-			res = parser_stmt_block(self);
+			parser_block_open(self, blocks, Parse_Block::KIND_BLOCK, nullptr, tkn);
+			return nullptr;
 		}
 		else if(tkn.kind == Tkn::KIND_KEYWORD_IF)
 		{
-			res = parser_stmt_if(self);
+			parser_eat(self); //for the if
+			Expr* if_cond = parser_expr(self);
+			Stmt* stmt = stmt_if(if_cond, nullptr, mn::buf_new<Else_If>(), nullptr);
+			parser_block_open(self, blocks, Parse_Block::KIND_IF_BODY, stmt, tkn);
+			return nullptr;
 		}
 		else if(tkn.kind == Tkn::KIND_KEYWORD_FOR)
 		{
-			res = parser_stmt_for(self);
+			bool has_body = false;
+			res = parser_stmt_for_head(self, has_body);
+			if(has_body)
+			{
+				parser_block_open(self, blocks, Parse_Block::KIND_FOR_BODY, res, tkn);
+				return nullptr;
+			}
 		}
 		else if(tkn.kind == Tkn::KIND_KEYWORD_VAR)
 		{
@@ -929,6 +1262,105 @@ namespace zay
 		return res;
 	}
 
+	// closes the block at the top of the stack, it returns the stmt the block completes or nullptr if the
+	// stmt goes on with another block
+	inline static Stmt*
+	parser_block_close(Parser& self, mn::Buf<Parse_Block>& blocks)
+	{
+		parser_eat_must(self, Tkn::KIND_CLOSE_CURLY);
+		Parse_Block block = mn::buf_top(blocks);
+		mn::buf_pop(blocks);
+
+		Stmt* body = stmt_block(block.stmts);
+		Stmt* res = block.owner;
+		switch(block.kind)
+		{
+		case Parse_Block::KIND_BLOCK:
+			res = body;
+			break;
+		case Parse_Block::KIND_IF_BODY:
+			res->if_stmt.if_body = body;
+			break;
+		case Parse_Block::KIND_ELSE_IF_BODY:
+			mn::buf_top(res->if_stmt.else_ifs).body = body;
+			break;
+		case Parse_Block::KIND_ELSE_BODY:
+			res->if_stmt.else_body = body;
+			break;
+		case Parse_Block::KIND_FOR_BODY:
+			res->for_stmt.loop_body = body;
+			break;
+		default:
+			assert(false && "unreachable");
+			break;
+		}
+
+		if ((block.kind == Parse_Block::KIND_IF_BODY || block.kind == Parse_Block::KIND_ELSE_IF_BODY) &&
+			parser_eat_kind(self, Tkn::KIND_KEYWORD_ELSE))
+		{
+			if(parser_eat_kind(self, Tkn::KIND_KEYWORD_IF))
+			{
+				Expr* cond = parser_expr(self);
+				mn::buf_push(res->if_stmt.else_ifs, Else_If{cond, nullptr});
+				parser_block_open(self, blocks, Parse_Block::KIND_ELSE_IF_BODY, res, block.begin);
+			}
+			else
+			{
+				parser_block_open(self, blocks, Parse_Block::KIND_ELSE_BODY, res, block.begin);
+			}
+			return nullptr;
+		}
+
+		res->rng = Rng{ block.begin.rng.begin, parser_last_tkn(self).rng.end };
+		res->pos = block.begin.pos;
+		return res;
+	}
+
+	// parses the stmts of the open blocks until the stmt which opened the first one is done, the blocks are
+	// kept on an explicit stack so deeply nested stmts don't grow the call stack
+	inline static Stmt*
+	parser_blocks(Parser& self, mn::Buf<Parse_Block>& blocks)
+	{
+		while(true)
+		{
+			Stmt* stmt = nullptr;
+			if (parser_look_kind(self, Tkn::KIND_CLOSE_CURLY) ||
+				parser_eof(self))
+			{
+				stmt = parser_block_close(self, blocks);
+			}
+			else
+			{
+				stmt = parser_stmt_begin(self, blocks);
+			}
+
+			if(stmt == nullptr)
+				continue;
+			if(blocks.count == 0)
+				return stmt;
+			mn::buf_push(mn::buf_top(blocks).stmts, stmt);
+		}
+	}
+
+	inline static Stmt*
+	parser_stmt_block(Parser& self)
+	{
+		auto blocks = mn::buf_with_allocator<Parse_Block>(mn::memory::clib());
+		mn_defer(mn::buf_free(blocks));
+		parser_block_open(self, blocks, Parse_Block::KIND_BLOCK, nullptr, parser_look(self));
+		return parser_blocks(self, blocks);
+	}
+
+	Stmt*
+	parser_stmt(Parser& self)
+	{
+		auto blocks = mn::buf_with_allocator<Parse_Block>(mn::memory::clib());
+		mn_defer(mn::buf_free(blocks));
+		if(Stmt* res = parser_stmt_begin(self, blocks))
+			return res;
+		return parser_blocks(self, blocks);
+	}
+
 	Decl*
 	parser_decl(Parser& self)
 	{
@@ -948,6 +1380,14 @@ namespace zay
 			res = parser_decl_func(self);
 		}
 
+		else
+		{
+			parser_err(
+				self,
+				err_tkn(tkn, mn::strf("expected a declaration but found '{}'", tkn.str))
+			);
+		}
+
 		if(res)
 		{
 			res->rng = Rng{ tkn.rng.begin, parser_last_tkn(self).rng.end };
@@ -962,4 +1402,228 @@ namespace zay
 		parser_eat_must(self, Tkn::KIND_KEYWORD_PACKAGE);
 		return parser_eat_must(self, Tkn::KIND_ID);
 	}
-};
+
+	bool
+	src_parse(Src *src, MODE mode)
+	{
+		size_t slices_count = tkn_store_count(src->tkns) / PARSE_SLICE_MIN_COUNT;
+		size_t cores_count = std::thread::hardware_concurrency();
+		if(slices_count > cores_count)
+			slices_count = cores_count;
+		if(slices_count > 1)
+			return src_parse_parallel(src, mode, slices_count);
+
+		auto self = parser_new(src);
+		parser_src(self, mode);
+		return src_has_err(src) == false;
+	}
+
+	bool
+	src_parse_parallel(Src *src, MODE mode, size_t slices_count)
+	{
+		//the typenames are collected once upfront, the slices only read them
+		auto self = parser_new(src);
+
+		//split the tokens at the first top level declaration after each of the even split points
+		const auto& kinds = src->tkns.kinds;
+		size_t count = tkn_store_count(src->tkns);
+		auto begins = mn::buf_new<size_t>();
+		mn_defer(mn::buf_free(begins));
+		mn::buf_push(begins, size_t(0));
+		size_t depth = 0;
+		for(size_t i = 0; i < count && begins.count < slices_count; ++i)
+		{
+			uint8_t kind = kinds[i];
+			if(kind == Tkn::KIND_OPEN_CURLY || kind == Tkn::KIND_OPEN_PAREN || kind == Tkn::KIND_OPEN_BRACKET)
+			{
+				depth++;
+			}
+			else if(kind == Tkn::KIND_CLOSE_CURLY || kind == Tkn::KIND_CLOSE_PAREN || kind == Tkn::KIND_CLOSE_BRACKET)
+			{
+				//unbalanced brackets are syntax errors which send us to the sequential parse anyway
+				if(depth > 0)
+					depth--;
+			}
+			else if(depth == 0 &&
+				i > begins[begins.count - 1] &&
+				i >= count * begins.count / slices_count &&
+				parse_decl_begins(kinds, i))
+			{
+				mn::buf_push(begins, i);
+			}
+		}
+
+		if(begins.count < 2)
+		{
+			parser_src(self, mode);
+			return src_has_err(src) == false;
+		}
+
+		auto slices = mn::buf_new<Parse_Slice>();
+		mn_defer(mn::buf_free(slices));
+		//self is still used to parse sequentially on errors so its positions are left at the first token
+		const char* slice_it = self.tkns_it;
+		Pos slice_pos = self.tkns_pos;
+		for(size_t i = 0; i < begins.count; ++i)
+		{
+			Parse_Slice slice{};
+			slice.parser = self;
+			slice.parser.tkns_ix = begins[i];
+			//each slice counts its positions from its first token, which is counted from the previous one
+			const char* it = begin(src->content) + src->tkns.offsets[begins[i]];
+			slice_pos = pos_advance(slice_pos, slice_it, it);
+			slice_it = it;
+			slice.parser.tkns_it = slice_it;
+			slice.parser.tkns_pos = slice_pos;
+			if(i + 1 < begins.count)
+				slice.parser.tkns_end = begins[i + 1];
+			slice.arena = mn::allocator_arena_new(AST_ARENA_BLOCK_SIZE);
+			slice.decls = mn::buf_new<Decl*>();
+			slice.errs = mn::buf_new<Err>();
+			slice.has_package = i == 0 && mode != MODE::NONE;
+			mn::buf_push(slices, slice);
+		}
+
+		for(Parse_Slice& slice: slices)
+			slice.parser.errs = &slice.errs;
+
+		//the first slice is parsed on this thread
+		auto threads = mn::buf_new<mn::Thread>();
+		mn_defer(mn::buf_free(threads));
+		for(size_t i = 1; i < slices.count; ++i)
+			mn::buf_push(threads, mn::thread_new(parse_slice_worker, &slices[i], "zay parse slice"));
+		parse_slice_worker(&slices[0]);
+		for(mn::Thread thread: threads)
+		{
+			mn::thread_join(thread);
+			mn::thread_free(thread);
+		}
+
+		//the sequential parse stops at the first stopped slice so the ones after it are dropped
+		size_t used_count = 0;
+		bool has_errs = false;
+		for(const Parse_Slice& slice: slices)
+		{
+			used_count++;
+			if(slice.errs.count > 0)
+				has_errs = true;
+			if(slice.stopped)
+				break;
+		}
+
+		//a broken declaration may be cut at the slice end while the sequential parse reads past it and
+		//reports other errors, so we parse again sequentially to get exactly the same errors
+		if(has_errs)
+		{
+			for(Parse_Slice& slice: slices)
+				parse_slice_free(slice);
+			parser_src(self, mode);
+			return src_has_err(src) == false;
+		}
+
+		//stitch the slices together in order
+		src->ast.package = slices[0].package;
+		for(size_t i = 0; i < slices.count; ++i)
+		{
+			if(i < used_count)
+			{
+				mn::buf_concat(src->ast.decls, slices[i].decls);
+				mn::buf_push(src->ast.slice_arenas, slices[i].arena);
+				mn::buf_free(slices[i].decls);
+				mn::buf_free(slices[i].errs);
+			}
+			else
+			{
+				parse_slice_free(slices[i]);
+			}
+		}
+
+		return src_has_err(src) == false;
+	}
+
+
+	bool
+	src_scan_parse(Src *src, MODE mode)
+	{
+		//the parallel scan and parse are faster than scanning while parsing but they need the token store
+		if(src_scan_chunks_count(src) > 1)
+		{
+			if(src_scan(src) == false)
+				return false;
+			return src_parse(src, mode);
+		}
+
+		size_t errs_count = src->errs.count;
+		auto self = parser_stream_new(src);
+		if(src_has_err(src))
+			return false;
+
+		auto misses = mn::buf_new<Typename_Miss>();
+		mn_defer(mn::buf_free(misses));
+		auto marks = mn::buf_new<Parse_Mark>();
+		mn_defer(mn::buf_free(marks));
+		self.typename_misses = &misses;
+		mn::buf_clear(src->ast.typenames);
+		mn::buf_clear(src->ast.typenames_set);
+
+		//the nodes go into the AST arena, they're freed with the AST
+		mn::allocator_push(src->ast.arena);
+
+		if (mode != MODE::NONE)
+			src->ast.package = parser_pkg(self);
+
+		while(true)
+		{
+			while(parser_eof(self) == false)
+			{
+				Tkn tkn = parser_look(self);
+				mn::buf_push(marks, Parse_Mark{tkn.rng.begin, tkn.pos, src->errs.count});
+				if (Decl* d = parser_decl(self))
+					mn::buf_push(src->ast.decls, d);
+				else
+					break;
+			}
+
+			//a declaration which took a typename declared further down for something else may have stopped the
+			//parse, so we learn the typenames of the rest of the code before deciding to parse again
+			parser_stream_learn_typenames(self);
+
+			//now that all the typenames are known we parse again from the first declaration which took one
+			//of them for something else, the misses are in parse order so it's the first one we find
+			size_t reparse_ix = marks.count;
+			for(const Typename_Miss& miss: misses)
+			{
+				if(ast_typename_has(src->ast, miss.name))
+				{
+					reparse_ix = miss.decl_ix;
+					break;
+				}
+			}
+			if(reparse_ix >= marks.count)
+				break;
+			parser_stream_rewind(self, marks, reparse_ix);
+		}
+
+		mn::allocator_pop();
+
+		//the scan errors hide the parse errors like they do when scanning before parsing, so we drop the
+		//parse and report the scan errors of the whole code
+		if(self.scanner.errs_count > 0)
+		{
+			for(size_t i = errs_count; i < src->errs.count; ++i)
+				destruct(src->errs[i]);
+			mn::buf_resize(src->errs, errs_count);
+			mn::buf_clear(src->ast.decls);
+			mn::buf_clear(src->tkns.trivia);
+			src->ast.package = Tkn{};
+
+			auto trivia = mn::buf_new<Trivia>();
+			mn_defer(mn::buf_free(trivia));
+			auto scanner = scanner_new(src);
+			scanner.trivia = &trivia;
+			while(scanner_tkn(&scanner))
+				continue;
+		}
+		return src_has_err(src) == false;
+	}
+};
\ No newline at end of file
@@ -9,7 +9,7 @@ namespace zay
 	Stmt*
 	stmt_break(const Tkn& t)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_BREAK;
 		self->break_stmt = t;
 		return self;
@@ -18,7 +18,7 @@ namespace zay
 	Stmt*
 	stmt_continue(const Tkn& t)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_CONTINUE;
 		self->continue_stmt = t;
 		return self;
@@ -27,7 +27,7 @@ namespace zay
 	Stmt*
 	stmt_return(Expr *e)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_RETURN;
 		self->return_stmt = e;
 		return self;
@@ -36,7 +36,7 @@ namespace zay
 	Stmt*
 	stmt_if(Expr* if_cond, Stmt* if_body, const mn::Buf<Else_If>& else_ifs, Stmt* else_body)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_IF;
 		self->if_stmt.if_cond = if_cond;
 		self->if_stmt.if_body = if_body;
@@ -48,7 +48,7 @@ namespace zay
 	Stmt*
 	stmt_for(Stmt* init_stmt, Expr* loop_cond, Stmt* post_stmt, Stmt* loop_body)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_FOR;
 		self->for_stmt.init_stmt = init_stmt;
 		self->for_stmt.loop_cond = loop_cond;
@@ -60,7 +60,7 @@ namespace zay
 	Stmt*
 	stmt_var(Var v)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_VAR;
 		self->var_stmt = v;
 		return self;
@@ -69,7 +69,7 @@ namespace zay
 	Stmt*
 	stmt_block(const mn::Buf<Stmt*>& stmts)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_BLOCK;
 		self->block_stmt = stmts;
 		return self;
@@ -78,7 +78,7 @@ namespace zay
 	Stmt*
 	stmt_assign(const mn::Buf<Expr*>& lhs, const Tkn& op, const mn::Buf<Expr*>& rhs)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_ASSIGN;
 		self->assign_stmt.lhs = lhs;
 		self->assign_stmt.op = op;
@@ -89,7 +89,7 @@ namespace zay
 	Stmt*
 	stmt_expr(Expr* e)
 	{
-		auto self = mn::alloc<Stmt>();
+		auto self = mn::alloc_zerod<Stmt>();
 		self->kind = Stmt::KIND_EXPR;
 		self->expr_stmt = e;
 		return self;
@@ -104,9 +104,46 @@ namespace zay
 		return res;
 	}
 
-	void
-	stmt_free(Stmt* self)
+	Stmt*
+	stmt_child(Stmt* self, size_t ix)
 	{
+		switch(self->kind)
+		{
+		case Stmt::KIND_IF:
+		{
+			size_t count = 0;
+			if(self->if_stmt.if_body && count++ == ix)
+				return self->if_stmt.if_body;
+			for(const Else_If& e: self->if_stmt.else_ifs)
+				if(e.body && count++ == ix)
+					return e.body;
+			if(self->if_stmt.else_body && count++ == ix)
+				return self->if_stmt.else_body;
+			return nullptr;
+		}
+		case Stmt::KIND_FOR:
+		{
+			Stmt* children[] = {self->for_stmt.init_stmt, self->for_stmt.post_stmt, self->for_stmt.loop_body};
+			size_t count = 0;
+			for(Stmt* child: children)
+				if(child && count++ == ix)
+					return child;
+			return nullptr;
+		}
+		case Stmt::KIND_BLOCK:
+			return ix < self->block_stmt.count ? self->block_stmt[ix] : nullptr;
+		default:
+			return nullptr;
+		}
+	}
+
+	//the children are freed before their parent so it can still find them
+	inline static Stmt*
+	stmt_free_visit(mn::Allocator& allocator, Stmt* self, size_t step)
+	{
+		if(Stmt* child = stmt_child(self, step))
+			return child;
+
 		switch(self->kind)
 		{
 		case Stmt::KIND_BREAK:
@@ -117,24 +154,13 @@ namespace zay
 			break;
 		case Stmt::KIND_IF:
 			expr_free(self->if_stmt.if_cond);
-			stmt_free(self->if_stmt.if_body);
 			for(const Else_If& e: self->if_stmt.else_ifs)
-			{
 				expr_free(e.cond);
-				stmt_free(e.body);
-			}
 			mn::buf_free(self->if_stmt.else_ifs);
-			if(self->if_stmt.else_body)
-				stmt_free(self->if_stmt.else_body);
 			break;
 		case Stmt::KIND_FOR:
-			if(self->for_stmt.init_stmt)
-				stmt_free(self->for_stmt.init_stmt);
 			if(self->for_stmt.loop_cond)
 				expr_free(self->for_stmt.loop_cond);
-			if(self->for_stmt.post_stmt)
-				stmt_free(self->for_stmt.post_stmt);
-			stmt_free(self->for_stmt.loop_body);
 			break;
 		case Stmt::KIND_VAR:
 			var_free(self->var_stmt);
@@ -147,10 +173,20 @@ namespace zay
 			expr_free(self->expr_stmt);
 			break;
 		case Stmt::KIND_BLOCK:
-			destruct(self->block_stmt);
+			mn::buf_free(self->block_stmt);
 			break;
 		default: assert(false && "unreachable"); break;
 		}
-		mn::free(self);
+		mn::free_from(allocator, self);
+		return nullptr;
+	}
+
+	void
+	stmt_free(Stmt* self)
+	{
+		auto stack = mn::buf_with_allocator<Stmt_Walk_Frame>(mn::memory::clib());
+		mn::Allocator allocator = mn::allocator_top();
+		stmt_walk(stack, self, allocator, stmt_free_visit);
+		mn::buf_free(stack);
 	}
-}
+}
\ No newline at end of file
@@ -1,8 +1,39 @@
 #include "zay/parse/Type_Sign.h"
 #include "zay/parse/Decl.h"
 
+#include <mn/Memory.h>
+#include <mn/Thread.h>
+
 namespace zay
 {
+	//named, ptr and array atoms only hold tokens, func atoms can be shared too once their args are
+	inline static bool
+	type_sign_shareable(const mn::Buf<Type_Atom>& atoms)
+	{
+		for(const Type_Atom& atom: atoms)
+		{
+			switch(atom.kind)
+			{
+			case Type_Atom::KIND_NAMED:
+			case Type_Atom::KIND_PTR:
+			case Type_Atom::KIND_ARRAY:
+				break;
+			case Type_Atom::KIND_FUNC:
+				for(Type_Sign arg: atom.func.args)
+					if(arg && arg->interned == false)
+						return false;
+				if(atom.func.ret && atom.func.ret->interned == false)
+					return false;
+				break;
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	//API
 	Type_Atom
 	type_atom_named(const Tkn& t)
 	{
@@ -86,8 +117,10 @@ namespace zay
 		}
 		else if(self.kind == Type_Atom::KIND_FUNC)
 		{
-			destruct(self.func.args);
-			destruct(self.func.ret);
+			for(Type_Sign& arg: self.func.args)
+				type_sign_free(arg);
+			mn::buf_free(self.func.args);
+			type_sign_free(self.func.ret);
 		}
 	}
 
@@ -108,9 +141,113 @@ namespace zay
 			return type_atom_union(clone(self.union_fields));
 		case Type_Atom::KIND_ENUM:
 			return type_atom_enum(clone(self.enum_fields));
+		case Type_Atom::KIND_FUNC:
+		{
+			auto args = mn::buf_with_capacity<Type_Sign>(self.func.args.count);
+			for(const Type_Sign& arg: self.func.args)
+				mn::buf_push(args, clone(arg));
+			return type_atom_func(args, clone(self.func.ret));
+		}
 		default:
 			assert(false && "unreachable");
 			return Type_Atom{};
 		}
 	}
-}
+
+	void
+	type_sign_free(Type_Sign& self)
+	{
+		if(self && self->interned == false)
+		{
+			mn::destruct(self->atoms);
+			mn::free(self);
+		}
+		self = nullptr;
+	}
+
+	Type_Sign
+	clone(const Type_Sign& self)
+	{
+		if(self == nullptr || self->interned)
+			return self;
+
+		auto res = mn::alloc<Type_Sign_Node>();
+		res->atoms = mn::buf_with_capacity<Type_Atom>(self->atoms.count);
+		for(const Type_Atom& atom: self->atoms)
+			mn::buf_push(res->atoms, clone(atom));
+		res->type = nullptr;
+		res->interned = false;
+		return res;
+	}
+
+	Type_Sign_Table
+	type_sign_table_new()
+	{
+		Type_Sign_Table self{};
+		self.mtx = mn::mutex_new("zay type sign table");
+		self.arena = mn::allocator_arena_new();
+		self.nodes = mn::map_new<Type_Sign_Key, Type_Sign, Type_Sign_Key_Hasher>();
+		return self;
+	}
+
+	void
+	type_sign_table_free(Type_Sign_Table& self)
+	{
+		//the nodes and their atoms are in the arena
+		mn::map_free(self.nodes);
+		mn::allocator_free(self.arena);
+		mn::mutex_free(self.mtx);
+	}
+
+	Type_Sign
+	type_sign_from(Type_Sign_Table& table, mn::Buf<Type_Atom>& atoms)
+	{
+		if(atoms.count == 0)
+		{
+			mn::buf_free(atoms);
+			return nullptr;
+		}
+
+		//struct, union and enum atoms declare a new type so every use gets its own node
+		if(type_sign_shareable(atoms) == false)
+		{
+			auto self = mn::alloc<Type_Sign_Node>();
+			self->atoms = atoms;
+			self->type = nullptr;
+			self->interned = false;
+			return self;
+		}
+
+		Type_Sign res = nullptr;
+		mn::mutex_lock(table.mtx);
+		if(auto it = mn::map_lookup(table.nodes, Type_Sign_Key{&atoms}))
+		{
+			res = it->value;
+		}
+		else
+		{
+			//copy the atoms into the table so the node outlives the parser's memory
+			res = mn::alloc_zerod_from<Type_Sign_Node>(table.arena);
+			res->atoms = mn::buf_with_allocator<Type_Atom>(table.arena);
+			for(const Type_Atom& atom: atoms)
+			{
+				Type_Atom copy = atom;
+				if(atom.kind == Type_Atom::KIND_FUNC)
+				{
+					copy.func.args = mn::buf_with_allocator<Type_Sign>(table.arena);
+					for(Type_Sign arg: atom.func.args)
+						mn::buf_push(copy.func.args, arg);
+				}
+				mn::buf_push(res->atoms, copy);
+			}
+			res->type = nullptr;
+			res->interned = true;
+			mn::map_insert(table.nodes, Type_Sign_Key{&res->atoms}, res);
+		}
+		mn::mutex_unlock(table.mtx);
+
+		//the table has its own copy of the atoms
+		mn::destruct(atoms);
+		return res;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "zay/scan/Literal.h"
+
+#include <mn/Memory.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace zay
+{
+	inline static int
+	hex_value(char c)
+	{
+		if(c >= '0' && c <= '9')
+			return c - '0';
+		if(c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if(c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return 16;
+	}
+
+	// reads at most max_count digits of the given base, returns the number of digits it read, values past
+	// the last unicode rune stop growing since no escape accepts them
+	inline static size_t
+	digits_decode(const char* it, const char* end, int base, size_t max_count, uint32_t& value)
+	{
+		value = 0;
+		size_t count = 0;
+		while(it + count < end && count < max_count)
+		{
+			int digit = hex_value(it[count]);
+			if(digit >= base)
+				break;
+			if(value <= 0x10FFFF)
+				value = value * uint32_t(base) + uint32_t(digit);
+			++count;
+		}
+		return count;
+	}
+
+	inline static size_t
+	utf8_encode(uint32_t rune, char* out)
+	{
+		if(rune < 0x80)
+		{
+			out[0] = char(rune);
+			return 1;
+		}
+		else if(rune < 0x800)
+		{
+			out[0] = char(0xC0 | (rune >> 6));
+			out[1] = char(0x80 | (rune & 0x3F));
+			return 2;
+		}
+		else if(rune < 0x10000)
+		{
+			out[0] = char(0xE0 | (rune >> 12));
+			out[1] = char(0x80 | ((rune >> 6) & 0x3F));
+			out[2] = char(0x80 | (rune & 0x3F));
+			return 3;
+		}
+		out[0] = char(0xF0 | (rune >> 18));
+		out[1] = char(0x80 | ((rune >> 12) & 0x3F));
+		out[2] = char(0x80 | ((rune >> 6) & 0x3F));
+		out[3] = char(0x80 | (rune & 0x3F));
+		return 4;
+	}
+
+	// API
+	bool
+	literal_int_decode(const char* begin, const char* end, uint64_t& value)
+	{
+		value = 0;
+		int base = 10;
+		if(end - begin > 2 && begin[0] == '0')
+		{
+			switch(begin[1])
+			{
+			case 'b': case 'B': base = 2; begin += 2; break;
+			case 'o': case 'O': base = 8; begin += 2; break;
+			case 'd': case 'D': base = 10; begin += 2; break;
+			case 'x': case 'X': base = 16; begin += 2; break;
+			default: break;
+			}
+		}
+
+		for(const char* it = begin; it < end; ++it)
+		{
+			uint64_t digit = uint64_t(hex_value(*it));
+			if(digit >= uint64_t(base))
+				break;
+			if(value > (UINT64_MAX - digit) / uint64_t(base))
+				return false;
+			value = value * uint64_t(base) + digit;
+		}
+		return true;
+	}
+
+	double
+	literal_float_decode(const char* begin, const char* end)
+	{
+		//strtod needs a null terminated string and the source content isn't, so copy the literal
+		char small[64];
+		size_t count = size_t(end - begin);
+		if(count < sizeof(small))
+		{
+			::memcpy(small, begin, count);
+			small[count] = '\0';
+			return ::strtod(small, nullptr);
+		}
+
+		auto str = mn::str_from_substr(begin, end, mn::memory::tmp());
+		return ::strtod(str.ptr, nullptr);
+	}
+
+	void
+	literal_string_decode(const char* begin, const char* end, mn::Str& out)
+	{
+		mn::str_clear(out);
+		const char* it = begin;
+		while(it < end)
+		{
+			const char* escape_it = (const char*)::memchr(it, '\\', size_t(end - it));
+			if(escape_it == nullptr)
+				escape_it = end;
+			mn::str_block_push(out, mn::Block{(void*)it, size_t(escape_it - it)});
+			if(escape_it == end)
+				break;
+
+			//the scanner never ends a string body with a lone \ but be safe anyway
+			if(escape_it + 1 == end)
+			{
+				mn::str_block_push(out, mn::Block{(void*)escape_it, 1});
+				break;
+			}
+
+			char bytes[4];
+			size_t bytes_count = 1;
+			uint32_t value = 0;
+			it = escape_it + 2;
+			switch(escape_it[1])
+			{
+			case 'a': bytes[0] = '\a'; break;
+			case 'b': bytes[0] = '\b'; break;
+			case 'e': bytes[0] = '\x1B'; break;
+			case 'f': bytes[0] = '\f'; break;
+			case 'n': bytes[0] = '\n'; break;
+			case 'r': bytes[0] = '\r'; break;
+			case 't': bytes[0] = '\t'; break;
+			case 'v': bytes[0] = '\v'; break;
+			case '\\': bytes[0] = '\\'; break;
+			case '"': bytes[0] = '"'; break;
+			case '\'': bytes[0] = '\''; break;
+			case '?': bytes[0] = '?'; break;
+			case '0': case '1': case '2': case '3':
+			case '4': case '5': case '6': case '7':
+			{
+				it = escape_it + 1;
+				it += digits_decode(it, end, 8, 3, value);
+				if(value > 0xFF)
+					bytes_count = 0;
+				bytes[0] = char(value);
+				break;
+			}
+			case 'x':
+			{
+				size_t count = digits_decode(it, end, 16, size_t(end - it), value);
+				if(count == 0 || value > 0xFF)
+					bytes_count = 0;
+				bytes[0] = char(value);
+				it += count;
+				break;
+			}
+			case 'u':
+			case 'U':
+			{
+				size_t count = escape_it[1] == 'u' ? 4 : 8;
+				if (digits_decode(it, end, 16, count, value) < count ||
+					value > 0x10FFFF ||
+					(value >= 0xD800 && value <= 0xDFFF))
+				{
+					bytes_count = 0;
+					break;
+				}
+				bytes_count = utf8_encode(value, bytes);
+				it += count;
+				break;
+			}
+			default:
+				bytes_count = 0;
+				break;
+			}
+
+			//C compilers know the escapes we don't, so they keep their spelling and the C code gets them
+			if(bytes_count == 0)
+			{
+				it = escape_it + 2;
+				mn::str_block_push(out, mn::Block{(void*)escape_it, 2});
+				continue;
+			}
+			mn::str_block_push(out, mn::Block{bytes, bytes_count});
+		}
+	}
+}
\ No newline at end of file
@@ -1,28 +1,169 @@
 #include "zay/scan/Scanner.h"
+#include "zay/scan/Token_Listing.h"
+#include "zay/scan/Simd.h"
+#include "zay/scan/Literal.h"
+#include "zay/scan/Unicode.h"
 
 #include <mn/Memory.h>
 #include <mn/IO.h>
+#include <mn/Thread.h>
+#include <mn/Defer.h>
 
 #include <string.h>
+#include <stdint.h>
+
+#include <thread>
 
 namespace zay
 {
-	inline static bool
-	is_whitespace(mn::Rune c)
+	// token spellings expanded at compile time, Tkn::NAMES is the runtime twin of this table
+	constexpr const char* KEYWORD_SPELLINGS[] = {
+		#define TOKEN(k, s) s
+			TOKEN_LISTING
+		#undef TOKEN
+	};
+
+	// must be a power of 2
+	constexpr size_t KEYWORD_TABLE_SIZE = 64;
+
+	constexpr size_t
+	const_strlen(const char* str)
+	{
+		size_t res = 0;
+		while(str[res] != '\0')
+			++res;
+		return res;
+	}
+
+	// perfect hash of the keywords, it only looks at the first 2 chars, the last char and the length
+	// so it's only valid for strings with length >= 2
+	constexpr size_t
+	keyword_hash(const char* str, size_t len)
 	{
 		return (
-			c == ' ' ||
-			c == '\n' ||
-			c == '\r' ||
-			c == '\t' ||
-			c == '\v'
-		);
+			size_t(uint8_t(str[0])) +
+			size_t(uint8_t(str[1])) * 2 +
+			size_t(uint8_t(str[len - 1])) * 5 +
+			len * 7
+		) & (KEYWORD_TABLE_SIZE - 1);
+	}
+
+	struct Keyword_Table
+	{
+		Tkn::KIND kinds[KEYWORD_TABLE_SIZE];
+		size_t lens[KEYWORD_TABLE_SIZE];
+		size_t min_len;
+		size_t max_len;
+		bool perfect;
+	};
+
+	constexpr Keyword_Table
+	keyword_table_build()
+	{
+		Keyword_Table self{};
+		self.min_len = SIZE_MAX;
+		self.max_len = 0;
+		self.perfect = true;
+		for(size_t i = size_t(Tkn::KIND_KEYWORDS__BEGIN + 1);
+			i < size_t(Tkn::KIND_KEYWORDS__END);
+			++i)
+		{
+			size_t len = const_strlen(KEYWORD_SPELLINGS[i]);
+			if(len < self.min_len)
+				self.min_len = len;
+			if(len > self.max_len)
+				self.max_len = len;
+
+			size_t slot = keyword_hash(KEYWORD_SPELLINGS[i], len);
+			if(self.kinds[slot] != Tkn::KIND_NONE)
+				self.perfect = false;
+			self.kinds[slot] = Tkn::KIND(i);
+			self.lens[slot] = len;
+		}
+		return self;
+	}
+
+	constexpr Keyword_Table KEYWORDS = keyword_table_build();
+	static_assert(KEYWORDS.min_len >= 2, "keyword_hash needs keywords with at least 2 chars");
+	static_assert(KEYWORDS.perfect, "keyword_hash has collisions, tweak its multipliers or KEYWORD_TABLE_SIZE");
+
+	inline static Tkn::KIND
+	keyword_kind(const char* begin, const char* end)
+	{
+		size_t len = end - begin;
+		if(len < KEYWORDS.min_len || len > KEYWORDS.max_len)
+			return Tkn::KIND_ID;
+
+		size_t slot = keyword_hash(begin, len);
+		if (KEYWORDS.kinds[slot] != Tkn::KIND_NONE &&
+			KEYWORDS.lens[slot] == len &&
+			::memcmp(KEYWORD_SPELLINGS[KEYWORDS.kinds[slot]], begin, len) == 0)
+		{
+			return KEYWORDS.kinds[slot];
+		}
+		return Tkn::KIND_ID;
+	}
+
+	enum CHAR_CLASS: uint8_t
+	{
+		CHAR_CLASS_NONE = 0,
+		CHAR_CLASS_WHITESPACE = 1 << 0,
+		CHAR_CLASS_LETTER = 1 << 1,
+		CHAR_CLASS_DIGIT = 1 << 2,
+		// first or continuation byte of a multi byte utf-8 rune
+		CHAR_CLASS_UTF8 = 1 << 3
+	};
+
+	struct Char_Class_Table
+	{
+		uint8_t classes[256];
+	};
+
+	constexpr Char_Class_Table
+	char_class_table_build()
+	{
+		Char_Class_Table self{};
+		for(size_t i = 0; i < 256; ++i)
+		{
+			if (i == ' ' ||
+				i == '\n' ||
+				i == '\r' ||
+				i == '\t' ||
+				i == '\v')
+			{
+				self.classes[i] = CHAR_CLASS_WHITESPACE;
+			}
+			else if((i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z') || i == '_')
+			{
+				self.classes[i] = CHAR_CLASS_LETTER;
+			}
+			else if(i >= '0' && i <= '9')
+			{
+				self.classes[i] = CHAR_CLASS_DIGIT;
+			}
+			else if(i >= 0x80)
+			{
+				self.classes[i] = CHAR_CLASS_UTF8;
+			}
+		}
+		return self;
+	}
+
+	// one lookup per byte for the ascii range, only bytes with the high bit set go through utf-8 decoding
+	constexpr Char_Class_Table CHAR_CLASSES = char_class_table_build();
+
+	inline static uint8_t
+	char_class(char c)
+	{
+		return CHAR_CLASSES.classes[uint8_t(c)];
 	}
 
 	inline static bool
 	is_letter(mn::Rune c)
 	{
-		return (mn::rune_is_letter(c) || c == '_');
+		if(uint32_t(c) < 0x80)
+			return CHAR_CLASSES.classes[c] & CHAR_CLASS_LETTER;
+		return rune_is_id_start(c);
 	}
 
 	inline static bool
@@ -31,6 +172,94 @@ namespace zay
 		return (c >= '0' && c <= '9');
 	}
 
+	// returns the rune at the given position, ascii bytes are returned as is without decoding
+	inline static mn::Rune
+	rune_at(const char* it, const char* end_it)
+	{
+		if(it >= end_it)
+			return 0;
+		if(uint8_t(*it) < 0x80)
+			return *it;
+		return mn::rune_read(it);
+	}
+
+	inline static const char*
+	rune_after(const char* it)
+	{
+		if(uint8_t(*it) < 0x80)
+			return it + 1;
+		return mn::rune_next(it);
+	}
+
+	inline static char
+	byte_at(const char* it, const char* end_it)
+	{
+		if(it >= end_it)
+			return '\0';
+		return *it;
+	}
+
+	inline static void
+	scanner_newline(Scanner *self, const char* newline_it)
+	{
+		self->pos.line++;
+		self->pos.col = 1;
+		self->col_it = newline_it + 1;
+	}
+
+	// handles all the newlines in a block at once, mask has bit i set if there's a newline at block_it + i
+	inline static void
+	scanner_newlines(Scanner *self, const char* block_it, uint32_t mask)
+	{
+		if(mask == 0)
+			return;
+
+		self->pos.line += bit_count(mask);
+		self->pos.col = 1;
+		self->col_it = block_it + bit_last(mask) + 1;
+	}
+
+	inline static void
+	scanner_err(Scanner *self, const Err& e)
+	{
+		self->errs_count++;
+		if(self->errs)
+			mn::buf_push(*self->errs, e);
+		else
+			src_err(self->src, e);
+	}
+
+	// detached scanners don't intern, the chunks only keep the kinds and ranges and the strings are
+	// derived from the token store when the tokens are read so interning them here is wasted work
+	inline static const char*
+	scanner_intern(Scanner *self, const char* begin_it, const char* end_it)
+	{
+		if(self->errs)
+			return nullptr;
+		return intern_pool_get(self->src->str_table, begin_it, end_it);
+	}
+
+	// moves the scanner to the given position on the same line
+	inline static void
+	scanner_jump(Scanner *self, const char* it)
+	{
+		self->it = it;
+		self->c = rune_at(it, end(self->src->content));
+	}
+
+	// syncs the column of the current position, this is done once per token instead of once per rune
+	inline static Pos
+	scanner_pos(Scanner *self)
+	{
+		for(; self->col_it < self->it; ++self->col_it)
+		{
+			//only count the first byte of each rune
+			if((uint8_t(*self->col_it) & 0xC0) != 0x80)
+				self->pos.col++;
+		}
+		return self->pos;
+	}
+
 	inline static bool
 	scanner_eat(Scanner *self)
 	{
@@ -38,39 +267,65 @@ namespace zay
 			return false;
 
 		const char* prev_it = self->it;
-		auto prev_c = mn::rune_read(self->it);
+		scanner_jump(self, rune_after(self->it));
 
-		self->it = mn::rune_next(self->it);
-		self->c = mn::rune_read(self->it);
-
-		self->pos.col++;
-
-		if(prev_c == '\n')
-		{
-			self->pos.col = 1;
-			self->pos.line++;
-			src_line_end(self->src, prev_it);
-			src_line_begin(self->src, self->it);
-		}
+		if(*prev_it == '\n')
+			scanner_newline(self, prev_it);
 		return true;
 	}
 
 	inline static void
 	scanner_skip_whitespaces(Scanner *self)
 	{
-		while(is_whitespace(self->c))
-			if(scanner_eat(self) == false)
-				break;
+		const char* it = self->it;
+		const char* end_it = end(self->src->content);
+	#if ZAY_SIMD
+		for(; size_t(end_it - it) >= BLOCK_SIZE; it += BLOCK_SIZE)
+		{
+			uint32_t whitespaces = block_whitespace(it);
+			uint32_t newlines = block_match(it, '\n');
+			if(whitespaces != BLOCK_FULL)
+			{
+				//only count the newlines before the first non whitespace byte
+				uint32_t count = bit_first(~whitespaces);
+				scanner_newlines(self, it, newlines & ((1u << count) - 1));
+				scanner_jump(self, it + count);
+				return;
+			}
+			scanner_newlines(self, it, newlines);
+		}
+	#endif
+		while(it < end_it && (char_class(*it) & CHAR_CLASS_WHITESPACE))
+		{
+			if(*it == '\n')
+				scanner_newline(self, it);
+			++it;
+		}
+		scanner_jump(self, it);
 	}
 
-	inline static const char*
+	inline static void
 	scanner_id(Scanner *self)
 	{
-		const char* begin_it = self->it;
-		while(is_letter(self->c) || is_digit(self->c))
-			if(scanner_eat(self) == false)
+		const char* end_it = end(self->src->content);
+		const char* it = self->it;
+		while(it < end_it)
+		{
+			uint8_t c = char_class(*it);
+			if(c & (CHAR_CLASS_LETTER | CHAR_CLASS_DIGIT))
+			{
+				++it;
+			}
+			else if((c & CHAR_CLASS_UTF8) && rune_is_id_continue(mn::rune_read(it)))
+			{
+				it = mn::rune_next(it);
+			}
+			else
+			{
 				break;
-		return mn::str_intern(self->src->str_table, begin_it, self->it);
+			}
+		}
+		scanner_jump(self, it);
 	}
 
 	inline static int
@@ -85,34 +340,57 @@ namespace zay
 		return 16;
 	}
 
-	inline static bool
-	scanner_digits(Scanner *self, int base)
+	// returns the end of the digits run which starts at it
+	inline static const char*
+	digits_end(const char* it, const char* end_it, int base)
+	{
+		while(it < end_it && digit_value(uint8_t(*it)) < base)
+			++it;
+		return it;
+	}
+
+	// records the decoded value of the literal, the values are sorted by offset so scanning code which
+	// was already scanned doesn't record its literals twice
+	inline static void
+	scanner_value(Scanner *self, const Tkn *tkn, Tkn_Value value)
 	{
-		bool found = false;
-		while(digit_value(self->c) < base)
+		if(self->values == nullptr)
+			return;
+
+		auto& values = *self->values;
+		value.offset = uint32_t(tkn->rng.begin - begin(self->src->content));
+		if(values.count > 0 && values[values.count - 1].offset >= value.offset)
+			return;
+		mn::buf_push(values, value);
+	}
+
+	inline static void
+	scanner_int_value(Scanner *self, Tkn *tkn, const char* begin_it, const char* end_it)
+	{
+		Tkn_Value value{};
+		if(literal_int_decode(begin_it, end_it, value.integer) == false)
 		{
-			found = true;
-			if(scanner_eat(self) == false)
-				break;
+			scanner_err(self, Err{
+				tkn->pos,
+				Rng{begin_it, end_it},
+				mn::strf("int literal doesn't fit in 64 bits")
+			});
 		}
-		return found;
+		scanner_value(self, tkn, value);
 	}
 
 	inline static void
 	scanner_num(Scanner *self, Tkn *tkn)
 	{
 		const char* begin_it = self->it;
-		Pos begin_pos = self->pos;
+		const char* end_it = end(self->src->content);
+		const char* it = self->it;
 		tkn->kind = Tkn::KIND_INTEGER;
 
-		if(self->c == '0')
+		if(*it == '0')
 		{
-			const char* backup_it = self->it;
-			Pos backup_pos = self->pos;
-			scanner_eat(self); //for the 0
-
 			int base = 0;
-			switch(self->c)
+			switch(byte_at(it + 1, end_it))
 			{
 			case 'b': case 'B': base = 2; break;
 			case 'o': case 'O': base = 8; break;
@@ -123,115 +401,300 @@ namespace zay
 
 			if(base != 0)
 			{
-				if(scanner_digits(self, base) == false)
+				//skip the 0 and the base char
+				it += 2;
+				const char* digits_it = digits_end(it, end_it, base);
+				if(digits_it == it)
 				{
-					src_err(self->src, Err{
-						begin_pos,
-						Rng{begin_it, self->it},
-						mn::strf("illegal int literal {:c}", self->c)
+					scanner_err(self, Err{
+						tkn->pos,
+						Rng{begin_it, it},
+						mn::strf("illegal int literal {:c}", rune_at(it, end_it))
 					});
 				}
-				tkn->str = mn::str_intern(self->src->str_table, begin_it, self->it);
+				else
+				{
+					scanner_int_value(self, tkn, begin_it, digits_it);
+				}
+				scanner_jump(self, digits_it);
+				tkn->str = scanner_intern(self, begin_it, self->it);
 				return;
 			}
-
-			//this is not a 0x number
-			self->it = backup_it;
-			self->c = mn::rune_read(self->it);
-			self->pos = backup_pos;
 		}
 
 		//since this is not a 0x number
 		//it might be an integer or float so parse a decimal number anyway
-		if(scanner_digits(self, 10) == false)
-		{
-			src_err(self->src, Err{
-				begin_pos,
-				Rng{begin_it, self->it},
-				mn::strf("illegal int literal {:c}", self->c)
-			});
-		}
+		it = digits_end(it, end_it, 10);
 
 		//float part
-		if(self->c == '.')
+		if(byte_at(it, end_it) == '.')
 		{
 			tkn->kind = Tkn::KIND_FLOAT;
-			scanner_eat(self); //for the .
+			++it; //for the .
 			//parse the after . part
-			if(scanner_digits(self, 10) == false)
+			const char* digits_it = digits_end(it, end_it, 10);
+			if(digits_it == it)
 			{
-				src_err(self->src, Err{
-					begin_pos,
-					Rng{begin_it, self->it},
-					mn::strf("illegal float literal {:c}", self->c)
+				scanner_err(self, Err{
+					tkn->pos,
+					Rng{begin_it, it},
+					mn::strf("illegal float literal {:c}", rune_at(it, end_it))
 				});
 			}
+			it = digits_it;
 		}
 
 		//scientific notation part
-		if(self->c == 'e' || self->c == 'E')
+		char e = byte_at(it, end_it);
+		if(e == 'e' || e == 'E')
 		{
 			tkn->kind = Tkn::KIND_FLOAT;
-			scanner_eat(self); //for the e
-			if(self->c == '-' || self->c == '+')
-				scanner_eat(self);
-			if(scanner_digits(self, 10) == false)
+			++it; //for the e
+			char sign = byte_at(it, end_it);
+			if(sign == '-' || sign == '+')
+				++it;
+			const char* digits_it = digits_end(it, end_it, 10);
+			if(digits_it == it)
 			{
-				src_err(self->src, Err{
-					begin_pos,
-					Rng{begin_it, self->it},
-					mn::strf("illegal float literal {:c}", self->c)
+				scanner_err(self, Err{
+					tkn->pos,
+					Rng{begin_it, it},
+					mn::strf("illegal float literal {:c}", rune_at(it, end_it))
 				});
 			}
+			it = digits_it;
 		}
 
 		//finished the parsing of the number whether it's a float or int
-		tkn->str = mn::str_intern(self->src->str_table, begin_it, self->it);
+		if(tkn->kind == Tkn::KIND_INTEGER)
+		{
+			scanner_int_value(self, tkn, begin_it, it);
+		}
+		else
+		{
+			Tkn_Value value{};
+			value.real = literal_float_decode(begin_it, it);
+			scanner_value(self, tkn, value);
+		}
+		scanner_jump(self, it);
+		tkn->str = scanner_intern(self, begin_it, self->it);
 	}
 
 	inline static const char*
 	scanner_comment(Scanner *self)
 	{
 		const char* begin_it = self->it;
-		const char* end_it = self->it;
+		const char* content_end_it = end(self->src->content);
+		const char* newline_it = find_byte(begin_it, content_end_it, '\n');
+
+		//the comment stops one char before the \n which also drops the \r of windows style line endings
+		const char* end_it = newline_it;
+		if(newline_it < content_end_it && newline_it > begin_it)
+			end_it = newline_it - 1;
+
+		scanner_jump(self, newline_it);
+		scanner_eat(self); //for the \n
+		return scanner_intern(self, begin_it, end_it);
+	}
+
+	// skips the comments which begin before limit, and the whitespaces after them, and records
+	// their ranges as trivia without interning anything
+	inline static void
+	scanner_skip_trivia(Scanner *self, const char* limit)
+	{
+		const char* content_begin = begin(self->src->content);
+		const char* content_end = end(self->src->content);
+		while(self->it < limit && content_end - self->it >= 2 && self->it[0] == '/' && self->it[1] == '/')
+		{
+			const char* newline_it = find_byte(self->it, content_end, '\n');
+			mn::buf_push(*self->trivia, Trivia{
+				uint32_t(self->it - content_begin),
+				uint32_t(newline_it - self->it)
+			});
+			scanner_jump(self, newline_it);
+			scanner_eat(self); //for the \n
+			scanner_skip_whitespaces(self);
+		}
+	}
+
+	inline static void
+	scanner_string(Scanner *self, Tkn *tkn)
+	{
+		const char* it = self->it;
+		const char* end_it = end(self->src->content);
+		bool escaped = false;
 
-		while(self->c != '\n')
+		//jump over whole runs of the string body, only stop at the closing ", escapes, and newlines
+		while(true)
 		{
-			end_it = self->it;
-			//windows style line ending \r\n
-			if(self->c == '\r')
+			it = find_byte(it, end_it, '"', '\\', '\n');
+			if(it == end_it)
 			{
-				if(scanner_eat(self) == false)
-					break;
-				if(self->c == '\n')
-					break;
+				scanner_err(self, Err{
+					tkn->pos,
+					Rng{tkn->rng.begin, end_it},
+					mn::strf("unterminated string")
+				});
+				scanner_jump(self, it);
+				return;
 			}
 
-			if(scanner_eat(self) == false)
+			if(*it == '"')
 				break;
+
+			if(*it == '\\')
+			{
+				//skip the escaped char, it might be a \" or even a \n
+				escaped = true;
+				++it;
+				if(it == end_it)
+					continue;
+			}
+
+			if(*it == '\n')
+				scanner_newline(self, it);
+			++it;
 		}
 
-		scanner_eat(self); //for the \n
-		return mn::str_intern(self->src->str_table, begin_it, end_it);
+		//decode the body once here so later phases use the bytes directly instead of the spelling
+		//the values are interned even by detached scanners since nothing derives them later
+		const char* body_it = tkn->rng.begin + 1;
+		Tkn_Value value{};
+		if(escaped)
+		{
+			//escapes only shrink the body so one reservation is enough
+			auto decoded = mn::str_with_allocator(mn::memory::tmp());
+			mn::str_reserve(decoded, size_t(it - body_it));
+			literal_string_decode(body_it, it, decoded);
+			value.string = intern_pool_get(self->src->str_table, decoded.ptr, decoded.ptr + decoded.count);
+			value.count = uint32_t(decoded.count);
+		}
+		else
+		{
+			value.string = intern_pool_get(self->src->str_table, body_it, it);
+			value.count = uint32_t(it - body_it);
+		}
+		scanner_value(self, tkn, value);
+
+		scanner_jump(self, it + 1); //for the "
 	}
 
-	inline static const char*
-	scanner_string(Scanner *self)
+
+	// creates a scanner which begins at the given position and reports its errors into errs
+	// its positions are relative to the starting point
+	inline static Scanner
+	scanner_detached_new(Src *src, const char* it, mn::Buf<Err>* errs)
 	{
-		const char* begin_it = self->it;
-		const char* end_it = self->it;
+		auto self = scanner_new(src);
+		self.it = it;
+		self.c = rune_at(it, end(src->content));
+		self.col_it = it;
+		self.errs = errs;
+		return self;
+	}
+
+	// returns whether the byte at the offset is in the middle of a rune
+	inline static bool
+	utf8_is_continuation(Src *src, size_t offset)
+	{
+		return offset < src->content.count && (uint8_t(src->content.ptr[offset]) & 0xC0) == 0x80;
+	}
+
+	// the content stays valid utf-8 if the edit doesn't split a rune and the new text is valid utf-8
+	inline static bool
+	utf8_edit_is_safe(Src *src, size_t begin_offset, size_t end_offset, const char* text, size_t text_count)
+	{
+		if(utf8_is_continuation(src, begin_offset) || utf8_is_continuation(src, end_offset))
+			return false;
+		return utf8_validate(text, text + text_count) == text + text_count;
+	}
 
-		auto prev = self->c;
-		//eat all runes even those escaped by \ like \"
-		while(self->c != '"' || prev == '\\')
+	// returns the index of the first trivia which begins at or after the given offset
+	inline static size_t
+	trivia_lower_bound(const mn::Buf<Trivia>& trivia, size_t offset)
+	{
+		size_t first = 0;
+		size_t last = trivia.count;
+		while(first < last)
 		{
-			scanner_eat(self);
-			prev = self->c;
+			size_t mid = first + (last - first) / 2;
+			if(trivia[mid].offset < offset)
+				first = mid + 1;
+			else
+				last = mid;
 		}
+		return first;
+	}
+
+	// files smaller than this are scanned sequentially, it's also the smallest chunk size
+	constexpr size_t SCAN_CHUNK_MIN_SIZE = 1024 * 1024;
 
-		end_it = self->it;
-		scanner_eat(self); //for the "
-		return mn::str_intern(self->src->str_table, begin_it, end_it);
+	// a chunk of the source code scanned on its own thread, it scans every token which begins in
+	// [begin, end), the last token may go beyond end like a multiline string
+	struct Scan_Chunk
+	{
+		const char* begin;
+		const char* end;
+		// number of newlines in [begin, end), used to fix up the error lines
+		size_t lines_count;
+		Scanner scanner;
+		Tkn_Store tkns;
+		mn::Buf<Err> errs;
+		// end of the last scanned token
+		const char* last_end;
+		// the scanner stopped at an illegal rune, nothing after this chunk is scanned
+		bool stopped;
+		// the chunk was scanned as part of the chunk before it
+		bool merged;
+	};
+
+	inline static void
+	scan_chunk_run(Scan_Chunk* self)
+	{
+		while(true)
+		{
+			Scanner prev = self->scanner;
+			size_t errs_count = self->errs.count;
+			size_t trivia_count = self->tkns.trivia.count;
+			size_t values_count = self->tkns.values.count;
+			Tkn tkn = scanner_tkn(&self->scanner);
+
+			//the token belongs to the next chunk or we hit the eof, so rewind in case we need to continue
+			//into that chunk, the rewind also gives back the comments which were skipped looking for it
+			if(tkn.rng.begin == nullptr || tkn.rng.begin >= self->end)
+			{
+				self->scanner = prev;
+				for(size_t i = errs_count; i < self->errs.count; ++i)
+					destruct(self->errs[i]);
+				mn::buf_resize(self->errs, errs_count);
+				mn::buf_resize(self->tkns.trivia, trivia_count);
+				mn::buf_resize(self->tkns.values, values_count);
+				//the comments which begin in this chunk are still ours, the next chunk skips the rest
+				if(self->scanner.trivia)
+				{
+					scanner_skip_whitespaces(&self->scanner);
+					scanner_skip_trivia(&self->scanner, self->end);
+				}
+				break;
+			}
+
+			if(tkn == false)
+			{
+				self->stopped = true;
+				break;
+			}
+
+			tkn_store_push(self->tkns, begin(self->scanner.src->content), tkn);
+			self->last_end = tkn.rng.end;
+		}
+	}
+
+	inline static void
+	scan_chunk_worker(void* arg)
+	{
+		auto self = (Scan_Chunk*)arg;
+		self->lines_count = count_byte(self->begin, self->end, '\n');
+		scan_chunk_run(self);
 	}
 
 
@@ -240,30 +703,26 @@ namespace zay
 	scanner_tkn(Scanner *self)
 	{
 		scanner_skip_whitespaces(self);
+		if(self->trivia)
+			scanner_skip_trivia(self, end(self->src->content));
 
 		if(scanner_eof(self))
 			return Tkn{};
 
 		Tkn tkn{};
-		tkn.pos = self->pos;
+		tkn.pos = scanner_pos(self);
 		tkn.rng.begin = self->it;
 
 		if(is_letter(self->c))
 		{
-			tkn.kind = Tkn::KIND_ID;
-			tkn.str = scanner_id(self);
-
-			//let's loop over all the keywords and check them
-			for(size_t i = size_t(Tkn::KIND_KEYWORDS__BEGIN + 1);
-				i < size_t(Tkn::KIND_KEYWORDS__END);
-				++i)
-			{
-				if(::strcmp(tkn.str, Tkn::NAMES[i]) == 0)
-				{
-					tkn.kind = Tkn::KIND(i);
-					break;
-				}
-			}
+			scanner_id(self);
+			//one probe into the keyword table, if it's not there then it's an id
+			tkn.kind = keyword_kind(tkn.rng.begin, self->it);
+			//keywords have a fixed spelling so only ids are interned
+			if(tkn.kind == Tkn::KIND_ID)
+				tkn.str = scanner_intern(self, tkn.rng.begin, self->it);
+			else
+				tkn.str = Tkn::NAMES[tkn.kind];
 		}
 		else if(is_digit(self->c))
 		{
@@ -271,11 +730,10 @@ namespace zay
 		}
 		else
 		{
-			//now for operators
+			//now for operators, all of them are ascii so we just move a pointer over the bytes
 			auto c = self->c;
-			Pos begin_pos = self->pos;
-			scanner_eat(self);
-			bool no_intern = false;
+			const char* it = rune_after(self->it);
+			const char* end_it = end(self->src->content);
 
 			switch(c)
 			{
@@ -291,141 +749,143 @@ namespace zay
 			case '.': tkn.kind = Tkn::KIND_DOT; break;
 			case '"':
 				tkn.kind = Tkn::KIND_STRING;
-				scanner_string(self);
+				scanner_jump(self, it);
+				scanner_string(self, &tkn);
+				it = self->it;
 				break;
 			case '<':
 				tkn.kind = Tkn::KIND_LESS;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_LESS_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				if(self->c == '<')
+				if(byte_at(it, end_it) == '<')
 				{
 					tkn.kind = Tkn::KIND_LEFT_SHIFT;
-					scanner_eat(self);
-					if(self->c == '=')
+					++it;
+					if(byte_at(it, end_it) == '=')
 					{
 						tkn.kind = Tkn::KIND_LEFT_SHIFT_EQUAL;
-						scanner_eat(self);
+						++it;
 					}
 				}
 				break;
 			case '>':
 				tkn.kind = Tkn::KIND_GREATER;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_GREATER_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '>')
+				else if(byte_at(it, end_it) == '>')
 				{
 					tkn.kind = Tkn::KIND_RIGHT_SHIFT;
-					scanner_eat(self);
-					if(self->c == '=')
+					++it;
+					if(byte_at(it, end_it) == '=')
 					{
 						tkn.kind = Tkn::KIND_RIGHT_SHIFT_EQUAL;
-						scanner_eat(self);
+						++it;
 					}
 				}
 				break;
 			case '=':
 				tkn.kind = Tkn::KIND_EQUAL;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_EQUAL_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '+':
 				tkn.kind = Tkn::KIND_PLUS;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_PLUS_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '+')
+				else if(byte_at(it, end_it) == '+')
 				{
 					tkn.kind = Tkn::KIND_INC;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '-':
 				tkn.kind = Tkn::KIND_MINUS;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_MINUS_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '-')
+				else if(byte_at(it, end_it) == '-')
 				{
 					tkn.kind = Tkn::KIND_DEC;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '*':
 				tkn.kind = Tkn::KIND_STAR;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_STAR_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '/':
 				tkn.kind = Tkn::KIND_DIV;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_DIV_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '/')
+				else if(byte_at(it, end_it) == '/')
 				{
 					tkn.kind = Tkn::KIND_COMMENT;
-					scanner_eat(self); //for the second /
+					scanner_jump(self, it + 1); //for the second /
 					tkn.str = scanner_comment(self);
-					no_intern = true;
+					it = self->it;
 				}
 				break;
 			case '%':
 				tkn.kind = Tkn::KIND_MOD;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_MOD_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '|':
 				tkn.kind = Tkn::KIND_BIT_OR;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_BIT_OR_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '|')
+				else if(byte_at(it, end_it) == '|')
 				{
 					tkn.kind = Tkn::KIND_LOGIC_OR;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '&':
 				tkn.kind = Tkn::KIND_BIT_AND;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_BIT_AND_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
-				else if(self->c == '&')
+				else if(byte_at(it, end_it) == '&')
 				{
 					tkn.kind = Tkn::KIND_LOGIC_AND;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '^':
 				tkn.kind = Tkn::KIND_BIT_XOR;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_BIT_XOR_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			case '~':
@@ -433,26 +893,306 @@ namespace zay
 				break;
 			case '!':
 				tkn.kind = Tkn::KIND_LOGIC_NOT;
-				if(self->c == '=')
+				if(byte_at(it, end_it) == '=')
 				{
 					tkn.kind = Tkn::KIND_NOT_EQUAL;
-					scanner_eat(self);
+					++it;
 				}
 				break;
 			default:
-				src_err(self->src, Err{
-					begin_pos,
+				scanner_err(self, Err{
+					tkn.pos,
 					Rng{},
 					mn::strf("illegal rune {:c}", c)
 				});
 				break;
 			}
 
-			if(no_intern == false)
-				tkn.str = mn::str_intern(self->src->str_table, tkn.rng.begin, self->it);
+			//comments and strings have already moved the scanner
+			if(it != self->it)
+				scanner_jump(self, it);
+
+			//operators have a fixed spelling so only strings are interned
+			if(tkn.kind == Tkn::KIND_STRING)
+				tkn.str = scanner_intern(self, tkn.rng.begin, self->it);
+			else if(tkn.kind != Tkn::KIND_COMMENT)
+				tkn.str = Tkn::NAMES[tkn.kind];
 		}
 
 		tkn.rng.end = self->it;
 		return tkn;
 	}
+
+	bool
+	src_validate_utf8(Src *src)
+	{
+		const char* it = utf8_validate(begin(src->content), end(src->content));
+		if(it == end(src->content))
+			return true;
+
+		//no range since the error printer can't walk the runes of an invalid line
+		src_err(src, Err{
+			src_pos(src, it),
+			Rng{},
+			mn::strf("invalid utf-8")
+		});
+		return false;
+	}
+
+	size_t
+	src_scan_chunks_count(const Src *src)
+	{
+		size_t chunks_count = src->content.count / SCAN_CHUNK_MIN_SIZE;
+		size_t cores_count = std::thread::hardware_concurrency();
+		if(chunks_count > cores_count)
+			chunks_count = cores_count;
+		if(chunks_count < 1)
+			chunks_count = 1;
+		return chunks_count;
+	}
+
+	bool
+	src_scan(Src *src)
+	{
+		size_t chunks_count = src_scan_chunks_count(src);
+		if(chunks_count > 1)
+			return src_scan_chunked(src, chunks_count);
+
+		if(src_validate_utf8(src) == false)
+			return false;
+
+		auto self = scanner_new(src);
+		while(true)
+		{
+			if(Tkn tkn = scanner_tkn(&self))
+				src_tkn(src, tkn);
+			else
+				break;
+		}
+		return src_has_err(src) == false;
+	}
+
+	bool
+	src_scan_chunked(Src *src, size_t chunks_count)
+	{
+		if(src_validate_utf8(src) == false)
+			return false;
+
+		const char* content_begin = begin(src->content);
+		const char* content_end = end(src->content);
+
+		//split the content right after newlines, we guess that these newlines are not inside a string
+		//and fix it up after scanning
+		auto chunks = mn::buf_new<Scan_Chunk>();
+		mn_defer(mn::buf_free(chunks));
+		const char* chunk_begin = content_begin;
+		for(size_t i = 1; i <= chunks_count && chunk_begin < content_end; ++i)
+		{
+			const char* chunk_end = content_end;
+			if(i < chunks_count)
+			{
+				const char* split_it = content_begin + src->content.count * i / chunks_count;
+				if(split_it < chunk_begin)
+					split_it = chunk_begin;
+				chunk_end = find_byte(split_it, content_end, '\n');
+				if(chunk_end < content_end)
+					++chunk_end;
+			}
+
+			Scan_Chunk chunk{};
+			chunk.begin = chunk_begin;
+			chunk.end = chunk_end;
+			chunk.tkns = tkn_store_new();
+			chunk.errs = mn::buf_new<Err>();
+			chunk.scanner = scanner_detached_new(src, chunk_begin, nullptr);
+			//only the first line counts its columns from 0
+			if(chunk_begin != content_begin)
+				chunk.scanner.pos.col = 1;
+			chunk.last_end = chunk_begin;
+			mn::buf_push(chunks, chunk);
+
+			chunk_begin = chunk_end;
+		}
+
+		for(Scan_Chunk& chunk: chunks)
+		{
+			chunk.scanner.errs = &chunk.errs;
+			if(chunk.scanner.trivia)
+				chunk.scanner.trivia = &chunk.tkns.trivia;
+			chunk.scanner.values = &chunk.tkns.values;
+		}
+
+		//the first chunk is scanned on this thread
+		auto threads = mn::buf_new<mn::Thread>();
+		mn_defer(mn::buf_free(threads));
+		for(size_t i = 1; i < chunks.count; ++i)
+			mn::buf_push(threads, mn::thread_new(scan_chunk_worker, &chunks[i], "zay scan chunk"));
+		if(chunks.count > 0)
+			scan_chunk_worker(&chunks[0]);
+		for(mn::Thread thread: threads)
+		{
+			mn::thread_join(thread);
+			mn::thread_free(thread);
+		}
+
+		//if a token crossed into the next chunk then our guess was wrong, so we continue scanning
+		//the chunk sequentially over the next one
+		size_t prev = 0;
+		for(size_t i = 1; i < chunks.count; ++i)
+		{
+			if(chunks[prev].stopped)
+				break;
+
+			if(chunks[prev].last_end <= chunks[i].begin)
+			{
+				prev = i;
+				continue;
+			}
+
+			chunks[prev].end = chunks[i].end;
+			scan_chunk_run(&chunks[prev]);
+			chunks[i].merged = true;
+		}
+
+		//stitch the chunks together in order
+		size_t lines_count = 0;
+		bool stopped = false;
+		for(Scan_Chunk& chunk: chunks)
+		{
+			if(stopped || chunk.merged)
+			{
+				destruct(chunk.errs);
+			}
+			else
+			{
+				mn::buf_concat(src->tkns.kinds, chunk.tkns.kinds);
+				mn::buf_concat(src->tkns.offsets, chunk.tkns.offsets);
+				mn::buf_concat(src->tkns.lens, chunk.tkns.lens);
+				mn::buf_concat(src->tkns.trivia, chunk.tkns.trivia);
+				mn::buf_concat(src->tkns.values, chunk.tkns.values);
+				for(Err& e: chunk.errs)
+				{
+					e.pos.line += uint32_t(lines_count);
+					src_err(src, e);
+				}
+				mn::buf_free(chunk.errs);
+				stopped = chunk.stopped;
+			}
+			lines_count += chunk.lines_count;
+			tkn_store_free(chunk.tkns);
+		}
+
+		return src_has_err(src) == false;
+	}
+	bool
+	src_edit(Src *src, size_t begin_offset, size_t end_offset, const char* text, size_t text_count)
+	{
+		//if there are errors then the tokens may have stopped at an illegal rune and the errors point into
+		//the old content, so we just scan everything again, the same goes for edits which might break
+		//the utf-8 of the content which is only validated by a full scan
+		if(src_has_err(src) || utf8_edit_is_safe(src, begin_offset, end_offset, text, text_count) == false)
+		{
+			src_content_replace(src, begin_offset, end_offset, text, text_count);
+			destruct(src->errs);
+			src->errs = mn::buf_new<Err>();
+			tkn_store_free(src->tkns);
+			src->tkns = tkn_store_new();
+			return src_scan(src);
+		}
+
+		const auto& offsets = src->tkns.offsets;
+		const auto& lens = src->tkns.lens;
+		size_t count = tkn_store_count(src->tkns);
+
+		//find the first token which ends at or after the edit, the tokens before it can't change
+		size_t first = 0;
+		size_t last = count;
+		while(first < last)
+		{
+			size_t mid = first + (last - first) / 2;
+			if(offsets[mid] + lens[mid] < begin_offset)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+		size_t restart_offset = first > 0 ? offsets[first - 1] + lens[first - 1] : 0;
+
+		src_content_replace(src, begin_offset, end_offset, text, text_count);
+		int64_t shift = int64_t(text_count) - int64_t(end_offset - begin_offset);
+		size_t edit_end_offset = begin_offset + text_count;
+
+		const char* content_begin = begin(src->content);
+		auto errs = mn::buf_new<Err>();
+		mn_defer(mn::buf_free(errs));
+		auto tkns = tkn_store_new();
+		mn_defer(tkn_store_free(tkns));
+		auto trivia = mn::buf_new<Trivia>();
+		mn_defer(mn::buf_free(trivia));
+		auto scanner = scanner_detached_new(src, content_begin + restart_offset, &errs);
+		if(scanner.trivia)
+			scanner.trivia = &trivia;
+		auto values = mn::buf_new<Tkn_Value>();
+		mn_defer(mn::buf_free(values));
+		scanner.values = &values;
+
+		//scan until a token after the edit begins where an old token began, scanning is context free
+		//so all the tokens after that are the same as the old ones
+		size_t resync = count;
+		size_t old_ix = first;
+		while(true)
+		{
+			Tkn tkn = scanner_tkn(&scanner);
+			if(tkn == false)
+				break;
+
+			size_t offset = tkn.rng.begin - content_begin;
+			if(offset >= edit_end_offset)
+			{
+				while(old_ix < count && int64_t(offsets[old_ix]) + shift < int64_t(offset))
+					++old_ix;
+				if (old_ix < count &&
+					offsets[old_ix] >= end_offset &&
+					int64_t(offsets[old_ix]) + shift == int64_t(offset))
+				{
+					resync = old_ix;
+					break;
+				}
+			}
+			tkn_store_push(tkns, content_begin, tkn);
+		}
+		//the comments and the values are rescanned over the same range as the tokens, which in the old
+		//content is [restart_offset, offset of the resync token)
+		size_t old_end_offset = resync < count ? offsets[resync] : SIZE_MAX;
+		if(scanner.trivia)
+		{
+			size_t trivia_first = trivia_lower_bound(src->tkns.trivia, restart_offset);
+			size_t trivia_last = trivia_lower_bound(src->tkns.trivia, old_end_offset);
+			tkn_store_trivia_splice(src->tkns, trivia_first, trivia_last, trivia, shift);
+		}
+		//the resync token is scanned but not kept so neither is its value
+		if (resync < count &&
+			values.count > 0 &&
+			int64_t(values[values.count - 1].offset) == int64_t(offsets[resync]) + shift)
+		{
+			mn::buf_pop(values);
+		}
+		size_t values_first = tkn_store_values_lower_bound(src->tkns, restart_offset);
+		size_t values_last = tkn_store_values_lower_bound(src->tkns, old_end_offset);
+		tkn_store_values_splice(src->tkns, values_first, values_last, values, shift);
+		tkn_store_splice(src->tkns, first, resync, tkns, shift);
+
+		//the scanner positions are relative to the restart point
+		if(errs.count > 0)
+		{
+			Pos base = src_pos(src, content_begin + restart_offset);
+			for(Err& e: errs)
+			{
+				if(e.pos.line == 1)
+					e.pos.col += base.col;
+				e.pos.line += base.line - 1;
+				src_err(src, e);
+			}
+		}
+		return src_has_err(src) == false;
+	}
 }
\ No newline at end of file
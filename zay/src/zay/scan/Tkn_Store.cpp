@@ -0,0 +1,127 @@
+#include "zay/scan/Tkn_Store.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace zay
+{
+	// KEYWORDS__END is the last token kind
+	static_assert(Tkn::KIND_KEYWORDS__END < 256, "token kinds don't fit in Tkn_Store::kinds");
+
+	// replaces the items [first, last) with the given items
+	template<typename T>
+	inline static void
+	buf_splice(mn::Buf<T>& self, size_t first, size_t last, const mn::Buf<T>& items)
+	{
+		size_t tail_count = self.count - last;
+		size_t count = first + items.count + tail_count;
+		if(count > self.count)
+			mn::buf_resize(self, count);
+		if(tail_count > 0)
+			::memmove(self.ptr + first + items.count, self.ptr + last, tail_count * sizeof(T));
+		if(items.count > 0)
+			::memcpy(self.ptr + first, items.ptr, items.count * sizeof(T));
+		mn::buf_resize(self, count);
+	}
+
+	Tkn_Store
+	tkn_store_new()
+	{
+		Tkn_Store self{};
+		self.kinds = mn::buf_new<uint8_t>();
+		self.offsets = mn::buf_new<uint32_t>();
+		self.lens = mn::buf_new<uint32_t>();
+		self.trivia = mn::buf_new<Trivia>();
+		self.values = mn::buf_new<Tkn_Value>();
+		return self;
+	}
+
+	void
+	tkn_store_free(Tkn_Store& self)
+	{
+		mn::buf_free(self.kinds);
+		mn::buf_free(self.offsets);
+		mn::buf_free(self.lens);
+		mn::buf_free(self.trivia);
+		mn::buf_free(self.values);
+	}
+
+	void
+	tkn_store_push(Tkn_Store& self, const char* base, const Tkn& tkn)
+	{
+		assert(tkn.rng.begin >= base && size_t(tkn.rng.end - base) <= UINT32_MAX && "token is out of the store range");
+		mn::buf_push(self.kinds, uint8_t(tkn.kind));
+		mn::buf_push(self.offsets, uint32_t(tkn.rng.begin - base));
+		mn::buf_push(self.lens, uint32_t(tkn.rng.end - tkn.rng.begin));
+	}
+
+	void
+	tkn_store_splice(Tkn_Store& self, size_t first, size_t last, const Tkn_Store& tkns, int64_t shift)
+	{
+		buf_splice(self.kinds, first, last, tkns.kinds);
+		buf_splice(self.offsets, first, last, tkns.offsets);
+		buf_splice(self.lens, first, last, tkns.lens);
+
+		for(size_t i = first + tkn_store_count(tkns); i < self.offsets.count; ++i)
+			self.offsets[i] = uint32_t(int64_t(self.offsets[i]) + shift);
+	}
+
+	void
+	tkn_store_trivia_splice(Tkn_Store& self, size_t first, size_t last, const mn::Buf<Trivia>& trivia, int64_t shift)
+	{
+		buf_splice(self.trivia, first, last, trivia);
+
+		for(size_t i = first + trivia.count; i < self.trivia.count; ++i)
+			self.trivia[i].offset = uint32_t(int64_t(self.trivia[i].offset) + shift);
+	}
+
+	void
+	tkn_store_values_splice(Tkn_Store& self, size_t first, size_t last, const mn::Buf<Tkn_Value>& values, int64_t shift)
+	{
+		buf_splice(self.values, first, last, values);
+
+		for(size_t i = first + values.count; i < self.values.count; ++i)
+			self.values[i].offset = uint32_t(int64_t(self.values[i].offset) + shift);
+	}
+
+	size_t
+	tkn_store_values_lower_bound(const Tkn_Store& self, size_t offset)
+	{
+		size_t first = 0;
+		size_t last = self.values.count;
+		while(first < last)
+		{
+			size_t mid = first + (last - first) / 2;
+			if(self.values[mid].offset < offset)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+		return first;
+	}
+
+	Tkn_Value
+	tkn_store_value(const Tkn_Store& self, size_t offset)
+	{
+		size_t ix = tkn_store_values_lower_bound(self, offset);
+		if(ix < self.values.count && self.values[ix].offset == offset)
+			return self.values[ix];
+		return Tkn_Value{};
+	}
+
+	size_t
+	tkn_store_lower_bound(const Tkn_Store& self, size_t offset)
+	{
+		size_t first = 0;
+		size_t last = self.offsets.count;
+		while(first < last)
+		{
+			size_t mid = first + (last - first) / 2;
+			if(self.offsets[mid] < offset)
+				first = mid + 1;
+			else
+				last = mid;
+		}
+		return first;
+	}
+}
\ No newline at end of file
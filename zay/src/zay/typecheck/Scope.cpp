@@ -1,16 +1,58 @@
 #include "zay/typecheck/Scope.h"
+#include "zay/Intern.h"
 
 #include <mn/Memory.h>
 
 namespace zay
 {
+	constexpr size_t SCOPE_TABLE_MIN_COUNT = 8;
+
+	inline static Sym*
+	scope_table_lookup(Scope* self, const char* name, uint64_t hash)
+	{
+		if(self->table.count == 0)
+			return nullptr;
+
+		size_t mask = self->table.count - 1;
+		for(size_t ix = size_t(hash) & mask; self->table[ix] != nullptr; ix = (ix + 1) & mask)
+		{
+			//interned names are the same pointer so no string compare is needed
+			if(self->table[ix]->name == name)
+				return self->table[ix];
+		}
+		return nullptr;
+	}
+
+	inline static void
+	scope_table_insert(mn::Buf<Sym*>& table, Sym* sym)
+	{
+		size_t mask = table.count - 1;
+		size_t ix = size_t(intern_hash_of(sym->name)) & mask;
+		while(table[ix] != nullptr)
+			ix = (ix + 1) & mask;
+		table[ix] = sym;
+	}
+
+	inline static void
+	scope_table_grow(Scope* self)
+	{
+		size_t count = self->table.count == 0 ? SCOPE_TABLE_MIN_COUNT : self->table.count * 2;
+		auto table = mn::buf_new<Sym*>();
+		mn::buf_resize_fill(table, count, (Sym*)nullptr);
+		for(Sym* sym: self->table)
+			if(sym)
+				scope_table_insert(table, sym);
+		mn::buf_free(self->table);
+		self->table = table;
+	}
+
 	Scope*
 	scope_new(Scope* parent, bool inside_loop, Type* ret)
 	{
 		Scope* self = mn::alloc<Scope>();
 		self->parent = parent;
 		self->syms = mn::buf_new<Sym*>();
-		self->table = mn::map_new<const char*, Sym*>();
+		self->table = mn::buf_new<Sym*>();
 		self->inside_loop = inside_loop;
 		self->ret = ret;
 		return self;
@@ -20,24 +62,24 @@ namespace zay
 	scope_free(Scope* self)
 	{
 		destruct(self->syms);
-		mn::map_free(self->table);
+		mn::buf_free(self->table);
 		mn::free(self);
 	}
 
 	Sym*
 	scope_has(Scope* self, const char* name)
 	{
-		if(auto it = mn::map_lookup(self->table, name))
-			return it->value;
-		return nullptr;
+		return scope_table_lookup(self, name, intern_hash_of(name));
 	}
 
 	Sym*
 	scope_find(Scope* self, const char* name)
 	{
+		//the hash is loaded once and each scope up the chain is a single probe
+		uint64_t hash = intern_hash_of(name);
 		for(auto it = self; it != nullptr; it = it->parent)
 		{
-			if(auto sym = scope_has(it, name))
+			if(auto sym = scope_table_lookup(it, name, hash))
 				return sym;
 		}
 		return nullptr;
@@ -47,7 +89,10 @@ namespace zay
 	scope_add(Scope* self, Sym* sym)
 	{
 		mn::buf_push(self->syms, sym);
-		mn::map_insert(self->table, sym->name, sym);
+		//keep the load under 1/2
+		if(self->syms.count * 2 > self->table.count)
+			scope_table_grow(self);
+		scope_table_insert(self->table, sym);
 		return sym;
 	}
 
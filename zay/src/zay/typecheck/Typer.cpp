@@ -1,4 +1,5 @@
 #include "zay/typecheck/Typer.h"
+#include "zay/parse/Parser.h"
 
 #include <mn/Memory.h>
 #include <mn/IO.h>
@@ -13,7 +14,7 @@ namespace zay
 	inline static Type*
 	typer_expr_resolve(Typer& self, Expr* expr);
 
-	inline static Type*
+	inline static void
 	typer_stmt_resolve(Typer& self, Stmt* stmt);
 
 	inline static Type*
@@ -96,6 +97,16 @@ namespace zay
 		return scope_find(typer_scope(self), name);
 	}
 
+	//the generated decls join the AST so they're allocated from its arena like the parsed ones
+	inline static Decl*
+	typer_unnamed_decl(Typer& self, const Tkn& id, const Type_Sign& sign)
+	{
+		mn::allocator_push(self.src->ast.arena);
+		Decl* res = decl_type(id, clone(sign));
+		mn::allocator_pop();
+		return res;
+	}
+
 	inline static Type*
 	token_to_type(const Tkn& tkn)
 	{
@@ -119,14 +130,83 @@ namespace zay
 		}
 	}
 
+	// where a type sign is written, interned signs share the tokens of their first use so the errors in them
+	// are reported at the use instead
+	struct Sign_Use
+	{
+		Pos pos;
+		Rng rng;
+	};
+
+	inline static Sign_Use
+	sign_use_tkn(const Tkn& t)
+	{
+		return Sign_Use{ t.pos, t.rng };
+	}
+
+	inline static Sign_Use
+	sign_use_expr(Expr* e)
+	{
+		return Sign_Use{ e->pos, e->rng };
+	}
+
+	inline static Err
+	err_sign_use(const Sign_Use& use, const mn::Str& m)
+	{
+		Err self{};
+		self.pos = use.pos;
+		self.rng = use.rng;
+		self.msg = m;
+		return self;
+	}
+
+	//the resolved type of an interned sign is shared by all of its uses so it only holds if its names mean
+	//the global symbols in the current scope, a local symbol can shadow them
+	inline static bool
+	typer_type_sign_names_global(Typer& self, const Type_Sign& sign)
+	{
+		if(typer_scope(self) == self.global_scope)
+			return true;
+
+		for(const Type_Atom& atom: sign->atoms)
+		{
+			if (atom.kind == Type_Atom::KIND_NAMED &&
+				type_is_same(token_to_type(atom.named), type_void) &&
+				typer_sym_by_name(self, atom.named.str) != scope_has(self.global_scope, atom.named.str))
+			{
+				return false;
+			}
+			else if(atom.kind == Type_Atom::KIND_FUNC)
+			{
+				//the func type is made of its args and return types so their names count too
+				for(const Type_Sign& arg: atom.func.args)
+					if(arg && typer_type_sign_names_global(self, arg) == false)
+						return false;
+				if(atom.func.ret && typer_type_sign_names_global(self, atom.func.ret) == false)
+					return false;
+			}
+		}
+		return true;
+	}
+
 	inline static Type*
-	typer_type_sign_resolve(Typer& self, const Type_Sign& sign, Type* incomplete_type)
+	typer_type_sign_resolve(Typer& self, const Type_Sign& sign, Type* incomplete_type, const Sign_Use& use)
 	{
 		Type* res = type_void;
+		if(sign == nullptr)
+			return res;
+
+		//interned signs are shared by all of their uses so they're resolved once, the named types completed
+		//with incomplete_type are the exception since each type decl makes its own type
+		bool names_global = typer_type_sign_names_global(self, sign);
+		if(incomplete_type == nullptr && sign->type && names_global)
+			return sign->type;
+		size_t errs_count = self.src->errs.count;
 
-		for(size_t i = 1; i <= sign.count; ++i)
+		const mn::Buf<Type_Atom>& atoms = sign->atoms;
+		for(size_t i = 1; i <= atoms.count; ++i)
 		{
-			const Type_Atom& atom = sign[sign.count - i];
+			const Type_Atom& atom = atoms[atoms.count - i];
 			switch(atom.kind)
 			{
 			case Type_Atom::KIND_NAMED:
@@ -147,7 +227,7 @@ namespace zay
 					{
 						src_err(
 							self.src,
-							err_tkn(atom.named, mn::strf("'{}' undefined symbol", atom.named.str))
+							err_sign_use(use, mn::strf("'{}' undefined symbol", atom.named.str))
 						);
 					}
 				}
@@ -166,7 +246,7 @@ namespace zay
 			{
 				size_t array_count = 0;
 				if (atom.count.kind == Tkn::KIND_INTEGER)
-					mn::reads(atom.count.str, array_count);
+					array_count = size_t(src_tkn_value(self.src, atom.count).integer);
 				res = type_intern_array(self.src->type_table, Array_Sign{ res, array_count });
 				break;
 			}
@@ -176,8 +256,8 @@ namespace zay
 				if(incomplete_type == nullptr)
 				{
 					auto name = mn::str_tmpf("__unnamed_struct_{}", self.unnamed_id++);
-					Tkn unnamed_id = tkn_anonymous_id(str_intern(self.src->str_table, name));
-					Decl* unnamed_decl = decl_type(unnamed_id, clone(sign));
+					Tkn unnamed_id = tkn_anonymous_id(intern_pool_get(self.src->str_table, name));
+					Decl* unnamed_decl = typer_unnamed_decl(self, unnamed_id, sign);
 					mn::buf_push(self.src->ast.decls, unnamed_decl);
 					auto unnamed_sym = sym_type(unnamed_decl);
 					scope_add(self.global_scope, unnamed_sym);
@@ -191,17 +271,18 @@ namespace zay
 				auto fields = mn::buf_new<Field_Sign>();
 				for(size_t j = 0; j < atom.struct_fields.count; ++j)
 				{
-					Type* field_type = typer_type_sign_resolve(self, atom.struct_fields[j].type, nullptr);
+					const Field& field = atom.struct_fields[j];
+					Type* field_type = typer_type_sign_resolve(self, field.type, nullptr, sign_use_tkn(field.ids[0]));
 					if (field_type->kind == Type::KIND_COMPLETING ||
 						field_type->kind == Type::KIND_INCOMPLETE)
 					{
 						typer_type_complete(self, field_type->sym);
 					}
 
-					for(size_t k = 0; k < atom.struct_fields[j].ids.count; ++k)
+					for(size_t k = 0; k < field.ids.count; ++k)
 					{
 						mn::buf_push(fields, Field_Sign{
-							atom.struct_fields[j].ids[k].str,
+							field.ids[k].str,
 							field_type,
 							0 //set the offset here to be 0 for now
 						});
@@ -216,8 +297,8 @@ namespace zay
 				if(incomplete_type == nullptr)
 				{
 					auto name = mn::str_tmpf("__unnamed_union_{}", self.unnamed_id++);
-					Tkn unnamed_id = tkn_anonymous_id(str_intern(self.src->str_table, name));
-					Decl* unnamed_decl = decl_type(unnamed_id, clone(sign));
+					Tkn unnamed_id = tkn_anonymous_id(intern_pool_get(self.src->str_table, name));
+					Decl* unnamed_decl = typer_unnamed_decl(self, unnamed_id, sign);
 					mn::buf_push(self.src->ast.decls, unnamed_decl);
 					auto unnamed_sym = sym_type(unnamed_decl);
 					scope_add(self.global_scope, unnamed_sym);
@@ -231,17 +312,18 @@ namespace zay
 				auto fields = mn::buf_new<Field_Sign>();
 				for(size_t j = 0; j < atom.union_fields.count; ++j)
 				{
-					Type* field_type = typer_type_sign_resolve(self, atom.union_fields[j].type, nullptr);
+					const Field& field = atom.union_fields[j];
+					Type* field_type = typer_type_sign_resolve(self, field.type, nullptr, sign_use_tkn(field.ids[0]));
 					if (field_type->kind == Type::KIND_COMPLETING ||
 						field_type->kind == Type::KIND_INCOMPLETE)
 					{
 						typer_type_complete(self, field_type->sym);
 					}
 
-					for(size_t k = 0; k < atom.union_fields[j].ids.count; ++k)
+					for(size_t k = 0; k < field.ids.count; ++k)
 					{
 						mn::buf_push(fields, Field_Sign{
-							atom.union_fields[j].ids[k].str,
+							field.ids[k].str,
 							field_type,
 							0 //set the offset here to be 0 for now
 						});
@@ -256,8 +338,8 @@ namespace zay
 				if(incomplete_type == nullptr)
 				{
 					auto name = mn::str_tmpf("__unnamed_enum_{}", self.unnamed_id++);
-					Tkn unnamed_id = tkn_anonymous_id(str_intern(self.src->str_table, name));
-					Decl* unnamed_decl = decl_type(unnamed_id, clone(sign));
+					Tkn unnamed_id = tkn_anonymous_id(intern_pool_get(self.src->str_table, name));
+					Decl* unnamed_decl = typer_unnamed_decl(self, unnamed_id, sign);
 					mn::buf_push(self.src->ast.decls, unnamed_decl);
 					auto unnamed_sym = sym_type(unnamed_decl);
 					scope_add(self.global_scope, unnamed_sym);
@@ -292,8 +374,8 @@ namespace zay
 			{
 				Func_Sign func_sign = func_sign_new();
 				for(const Type_Sign& arg: atom.func.args)
-					mn::buf_push(func_sign.args, typer_type_sign_resolve(self, arg, nullptr));
-				func_sign.ret = typer_type_sign_resolve(self, atom.func.ret, nullptr);
+					small_buf_push(func_sign.args, typer_type_sign_resolve(self, arg, nullptr, use));
+				func_sign.ret = typer_type_sign_resolve(self, atom.func.ret, nullptr, use);
 				res = type_intern_func(self.src->type_table, func_sign);
 				break;
 			}
@@ -303,6 +385,14 @@ namespace zay
 			}
 		}
 
+		//signs with errors aren't cached so every use of them reports its errors, neither are the ones
+		//resolved to shadowing local symbols
+		if (incomplete_type == nullptr &&
+			names_global &&
+			self.src->errs.count == errs_count)
+		{
+			sign->type = res;
+		}
 		return res;
 	}
 
@@ -324,7 +414,7 @@ namespace zay
 		if(sym->kind == Sym::KIND_TYPE)
 		{
 			Decl* decl = sym->type_sym;
-			sym->type = typer_type_sign_resolve(self, decl->type_decl, sym->type);
+			sym->type = typer_type_sign_resolve(self, decl->type_decl, sym->type, sign_use_tkn(decl->name));
 		}
 		else 
 		{
@@ -363,8 +453,8 @@ namespace zay
 	{
 		assert(expr->kind == Expr::KIND_BINARY);
 
-		Type* lhs_type = typer_expr_resolve(self, expr->binary.lhs);
-		Type* rhs_type = typer_expr_resolve(self, expr->binary.rhs);
+		Type* lhs_type = expr->binary.lhs->type;
+		Type* rhs_type = expr->binary.rhs->type;
 
 		if(type_is_same(lhs_type, rhs_type) == false)
 			src_err(self.src, err_expr(expr, mn::strf("type mismatch in binary expression")));
@@ -406,7 +496,7 @@ namespace zay
 	{
 		assert(expr->kind == Expr::KIND_UNARY);
 
-		Type* type = typer_expr_resolve(self, expr->unary.expr);
+		Type* type = expr->unary.expr->type;
 
 		//works with numbers
 		if (expr->unary.op.kind == Tkn::KIND_INC ||
@@ -466,7 +556,7 @@ namespace zay
 	typer_expr_dot_resolve(Typer& self, Expr* expr)
 	{
 		assert(expr->kind == Expr::KIND_DOT);
-		Type* type = typer_expr_resolve(self, expr->dot.base);
+		Type* type = expr->dot.base->type;
 		Type* unqualified_type = type_unqualify(type);
 		Type* res = type_void;
 		if(unqualified_type->kind == Type::KIND_STRUCT)
@@ -521,7 +611,7 @@ namespace zay
 	typer_expr_indexed_resolve(Typer& self, Expr* expr)
 	{
 		assert(expr->kind == Expr::KIND_INDEXED);
-		Type* type = typer_expr_resolve(self, expr->indexed.base);
+		Type* type = expr->indexed.base->type;
 		if(type->kind != Type::KIND_ARRAY)
 		{
 			src_err(
@@ -541,46 +631,59 @@ namespace zay
 		return type->array.base;
 	}
 
-	inline static Type*
-	typer_expr_call_resolve(Typer& self, Expr* expr)
+	//the args are walked one by one after the base, step i is called once arg i - 2 is resolved
+	inline static Expr*
+	typer_expr_call_visit(Typer& self, Expr* expr, size_t step)
 	{
 		assert(expr->kind == Expr::KIND_CALL);
-		Type* res = typer_expr_resolve(self, expr->call.base);
-		if(res->kind != Type::KIND_FUNC)
-		{
-			src_err(self.src, err_expr(expr->call.base, mn::strf("invalid call, expression is not a function")));
-			return type_void;
-		}
+		if(step == 0)
+			return expr->call.base;
 
-		if(expr->call.args.count != res->func.args.count)
+		Type* res = expr->call.base->type;
+		if(step == 1)
 		{
-			auto msg = mn::strf(
-				"function expected {} arguments but {} were provided",
-				res->func.args.count,
-				expr->call.args.count
-			);
-			src_err(self.src, err_expr(expr, msg));
-			return type_void;
-		}
+			if(res->kind != Type::KIND_FUNC)
+			{
+				src_err(self.src, err_expr(expr->call.base, mn::strf("invalid call, expression is not a function")));
+				expr->type = type_void;
+				return nullptr;
+			}
 
-		for(size_t i = 0; i < expr->call.args.count; ++i)
+			if(expr->call.args.count != res->func.args.count)
+			{
+				auto msg = mn::strf(
+					"function expected {} arguments but {} were provided",
+					res->func.args.count,
+					expr->call.args.count
+				);
+				src_err(self.src, err_expr(expr, msg));
+				expr->type = type_void;
+				return nullptr;
+			}
+		}
+		else
 		{
-			Type* type = typer_expr_resolve(self, expr->call.args[i]);
-			if(type_is_same(type, res->func.args[i]) == false)
+			size_t i = step - 2;
+			if(type_is_same(expr->call.args[i]->type, res->func.args[i]) == false)
 			{
 				auto msg = mn::strf("function argument {} type mismatch", i);
 				src_err(self.src, err_expr(expr->call.args[i], msg));
 			}
 		}
-		return res->func.ret;
+
+		if(step - 1 < expr->call.args.count)
+			return expr->call.args[step - 1];
+
+		expr->type = res->func.ret;
+		return nullptr;
 	}
 
 	inline static Type*
 	typer_expr_cast_resolve(Typer& self, Expr* expr)
 	{
 		assert(expr->kind == Expr::KIND_CAST);
-		Type* from_type = typer_expr_resolve(self, expr->cast.base);
-		Type* to_type = typer_type_sign_resolve(self, expr->cast.type, nullptr);
+		Type* from_type = expr->cast.base->type;
+		Type* to_type = typer_type_sign_resolve(self, expr->cast.type, nullptr, sign_use_expr(expr));
 
 		from_type = type_unwrap(from_type);
 		to_type = type_unwrap(to_type);
@@ -598,105 +701,134 @@ namespace zay
 	}
 
 	inline static Type*
-	typer_expr_paren_resolve(Typer& self, Expr* expr)
-	{
-		assert(expr->kind == Expr::KIND_PAREN);
-		return typer_expr_resolve(self, expr->paren);
-	}
-
-	inline static Type*
-	typer_expr_complit_resolve(Typer& self, Expr* expr)
+	typer_complit_field_type(Typer& self, Type* type, const Complit_Field& field, bool report)
 	{
-		assert(expr->kind == Expr::KIND_COMPLIT);
-		Type* type = typer_type_sign_resolve(self, expr->complit.type, nullptr);
-		for(size_t i = 0; i < expr->complit.fields.count; ++i)
+		Type* left_type = type_void;
+		if(field.kind == Complit_Field::KIND_MEMBER)
 		{
-			Complit_Field field = expr->complit.fields[i];
-			Type* left_type = type_void;
-			if(field.kind == Complit_Field::KIND_MEMBER)
+			if (type->kind == Type::KIND_STRUCT ||
+				type->kind == Type::KIND_UNION)
 			{
-				if (type->kind == Type::KIND_STRUCT ||
-					type->kind == Type::KIND_UNION)
+				for(size_t j = 0; j < type->fields.count; ++j)
 				{
-					for(size_t j = 0; j < type->fields.count; ++j)
+					if(field.left->atom.str == type->fields[j].name)
 					{
-						if(field.left->atom.str == type->fields[j].name)
-						{
-							left_type = type->fields[j].type;
-							break;
-						}
+						left_type = type->fields[j].type;
+						break;
 					}
 				}
-				if (type_is_same(left_type, type_void))
-				{
-					src_err(
-						self.src,
-						err_expr(field.left, mn::strf("'{}' type doesn't have this field", *type))
-					);
-				}
 			}
-			else if(field.kind == Complit_Field::KIND_ARRAY)
+			if (type_is_same(left_type, type_void) && report)
 			{
-				if(type->kind == Type::KIND_ARRAY)
-				{
-					left_type = type->array.base;
-				}
-				else
-				{
-					src_err(
-						self.src,
-						err_expr(field.left, mn::strf("'{}' type is not an array", *type))
-					);
-				}
+				src_err(
+					self.src,
+					err_expr(field.left, mn::strf("'{}' type doesn't have this field", *type))
+				);
 			}
+		}
+		else if(field.kind == Complit_Field::KIND_ARRAY)
+		{
+			if(type->kind == Type::KIND_ARRAY)
+			{
+				left_type = type->array.base;
+			}
+			else if(report)
+			{
+				src_err(
+					self.src,
+					err_expr(field.left, mn::strf("'{}' type is not an array", *type))
+				);
+			}
+		}
+		return left_type;
+	}
 
-			Type* right_type = typer_expr_resolve(self, field.right);
-
+	//only the right side of the fields is walked, step i comes once the right side of field i - 1 is resolved
+	inline static Expr*
+	typer_expr_complit_visit(Typer& self, Expr* expr, size_t step)
+	{
+		assert(expr->kind == Expr::KIND_COMPLIT);
+		if(step == 0)
+		{
+			expr->type = typer_type_sign_resolve(self, expr->complit.type, nullptr, sign_use_expr(expr));
+		}
+		else
+		{
+			const Complit_Field& field = expr->complit.fields[step - 1];
+			Type* left_type = typer_complit_field_type(self, expr->type, field, false);
+			Type* right_type = field.right->type;
 			if(type_is_same(left_type, right_type) == false)
 			{
 				auto msg = mn::strf("type mismatch, type '{}' expected but type '{}' was provided", *left_type, *right_type);
 				src_err(self.src, err_expr(field.right, msg));
 			}
 		}
-		return type;
+
+		if(step < expr->complit.fields.count)
+		{
+			const Complit_Field& field = expr->complit.fields[step];
+			typer_complit_field_type(self, expr->type, field, true);
+			return field.right;
+		}
+		return nullptr;
 	}
 
-	inline static Type*
-	typer_expr_resolve(Typer& self, Expr* expr)
+	//resolves the children first then the expr itself, the index of an indexed expr isn't resolved
+	inline static Expr*
+	typer_expr_visit(Typer& self, Expr* expr, size_t step)
 	{
 		switch(expr->kind)
 		{
 		case Expr::KIND_ATOM:
 			expr->type = typer_expr_atom_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_BINARY:
+			if(step == 0)
+				return expr->binary.lhs;
+			else if(step == 1)
+				return expr->binary.rhs;
 			expr->type = typer_expr_binary_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_UNARY:
+			if(step == 0)
+				return expr->unary.expr;
 			expr->type = typer_expr_unary_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_DOT:
+			if(step == 0)
+				return expr->dot.base;
 			expr->type = typer_expr_dot_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_INDEXED:
+			if(step == 0)
+				return expr->indexed.base;
 			expr->type = typer_expr_indexed_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_CALL:
-			expr->type = typer_expr_call_resolve(self, expr);
-			return expr->type;
+			return typer_expr_call_visit(self, expr, step);
 		case Expr::KIND_CAST:
+			if(step == 0)
+				return expr->cast.base;
 			expr->type = typer_expr_cast_resolve(self, expr);
-			return expr->type;
+			return nullptr;
 		case Expr::KIND_PAREN:
-			expr->type = typer_expr_paren_resolve(self, expr);
-			return expr->type;
+			if(step == 0)
+				return expr->paren;
+			expr->type = expr->paren->type;
+			return nullptr;
 		case Expr::KIND_COMPLIT:
-			expr->type = typer_expr_complit_resolve(self, expr);
-			return expr->type;
-		default: assert(false && "unreachable"); return type_void;
+			return typer_expr_complit_visit(self, expr, step);
+		default: assert(false && "unreachable"); return nullptr;
 		}
 	}
 
+	inline static Type*
+	typer_expr_resolve(Typer& self, Expr* expr)
+	{
+		expr_walk(self.expr_stack, expr, self, typer_expr_visit);
+		return expr->type;
+	}
+
 
 	inline static Type*
 	typer_stmt_break_resolve(Typer& self, Stmt* stmt)
@@ -740,22 +872,27 @@ namespace zay
 		return ret;
 	}
 
-	inline static Type*
-	typer_stmt_if_resolve(Typer& self, Stmt* stmt)
+	//step 0 resolves the if condition and step i the condition of the i-th else if, each before its body
+	inline static Stmt*
+	typer_stmt_if_visit(Typer& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_IF);
-		Type* type = typer_expr_resolve(self, stmt->if_stmt.if_cond);
-		if(type_is_same(type, type_bool) == false)
+		const auto& else_ifs = stmt->if_stmt.else_ifs;
+		if(step == 0)
 		{
-			src_err(
-				self.src,
-				err_expr(stmt->if_stmt.if_cond, mn::strf("if conditions type '{}' is not a boolean", *type))
-			);
+			Type* type = typer_expr_resolve(self, stmt->if_stmt.if_cond);
+			if(type_is_same(type, type_bool) == false)
+			{
+				src_err(
+					self.src,
+					err_expr(stmt->if_stmt.if_cond, mn::strf("if conditions type '{}' is not a boolean", *type))
+				);
+			}
+			return stmt->if_stmt.if_body;
 		}
-		typer_stmt_resolve(self, stmt->if_stmt.if_body);
-
-		for(const Else_If& e: stmt->if_stmt.else_ifs)
+		else if(step <= else_ifs.count)
 		{
+			const Else_If& e = else_ifs[step - 1];
 			Type* cond_type = typer_expr_resolve(self, e.cond);
 			if(type_is_same(cond_type, type_bool) == false)
 			{
@@ -764,43 +901,56 @@ namespace zay
 					err_expr(e.cond, mn::strf("if conditions type '{}' is not a boolean", *cond_type))
 				);
 			}
-			typer_stmt_resolve(self, e.body);
+			return e.body;
 		}
-
-		if(stmt->if_stmt.else_body)
-			typer_stmt_resolve(self, stmt->if_stmt.else_body);
-		return type_void;
+		else if(step == else_ifs.count + 1)
+		{
+			return stmt->if_stmt.else_body;
+		}
+		return nullptr;
 	}
 
-	inline static Type*
-	typer_stmt_for_resolve(Typer& self, Stmt* stmt)
+	//the init stmt, the post stmt and the stmts of the body are walked in the scope of the for stmt, the
+	//body doesn't get a scope of its own
+	inline static Stmt*
+	typer_stmt_for_visit(Typer& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_FOR);
+		const auto& for_stmt = stmt->for_stmt;
+		if(step == 0)
+		{
+			auto scope = src_scope_new(self.src, stmt, typer_scope(self), true, nullptr);
+			typer_scope_enter(self, scope);
+			if(for_stmt.init_stmt)
+				return for_stmt.init_stmt;
+		}
 
-		auto scope = src_scope_new(self.src, stmt, typer_scope(self), true, nullptr);
-		typer_scope_enter(self, scope);
-
-		if(stmt->for_stmt.init_stmt)
-			typer_stmt_resolve(self, stmt->for_stmt.init_stmt);
-		if(stmt->for_stmt.loop_cond)
+		size_t head_count = for_stmt.init_stmt ? 1 : 0;
+		if(step == head_count)
 		{
-			Type* cond_type = typer_expr_resolve(self, stmt->for_stmt.loop_cond);
-			if(type_is_same(cond_type, type_bool) == false)
+			if(for_stmt.loop_cond)
 			{
-				src_err(
-					self.src,
-					err_expr(stmt->for_stmt.loop_cond, mn::strf("for loop condition type '{}' is not a boolean", *cond_type))
-				);
+				Type* cond_type = typer_expr_resolve(self, for_stmt.loop_cond);
+				if(type_is_same(cond_type, type_bool) == false)
+				{
+					src_err(
+						self.src,
+						err_expr(for_stmt.loop_cond, mn::strf("for loop condition type '{}' is not a boolean", *cond_type))
+					);
+				}
 			}
+			if(for_stmt.post_stmt)
+				return for_stmt.post_stmt;
 		}
-		if(stmt->for_stmt.post_stmt)
-			typer_stmt_resolve(self, stmt->for_stmt.post_stmt);
 
-		for (Stmt* s : stmt->for_stmt.loop_body->block_stmt)
-			typer_stmt_resolve(self, s);
-		typer_scope_leave(self);
+		if(for_stmt.post_stmt)
+			head_count++;
+		size_t ix = step - head_count;
+		if(ix < for_stmt.loop_body->block_stmt.count)
+			return for_stmt.loop_body->block_stmt[ix];
 
-		return type_void;
+		typer_scope_leave(self);
+		return nullptr;
 	}
 
 	inline static Type*
@@ -808,11 +958,11 @@ namespace zay
 	{
 		assert(stmt->kind == Stmt::KIND_VAR);
 
-		bool infer = stmt->var_stmt.type.count == 0;
+		bool infer = stmt->var_stmt.type == nullptr;
 
 		Type* type = type_void;
 		if(infer == false)
-			type = typer_type_sign_resolve(self, stmt->var_stmt.type, nullptr);
+			type = typer_type_sign_resolve(self, stmt->var_stmt.type, nullptr, sign_use_tkn(stmt->var_stmt.ids[0]));
 
 		for(size_t i = 0; i < stmt->var_stmt.ids.count; ++i)
 		{
@@ -908,66 +1058,90 @@ namespace zay
 		return type_void;
 	}
 
-	inline static Type*
-	typer_anonymous_block_resolve(Typer& self, Stmt* stmt)
+	inline static Stmt*
+	typer_stmt_anonymous_block_visit(Typer& self, Stmt* stmt, size_t step)
 	{
 		assert(stmt->kind == Stmt::KIND_BLOCK);
+		if(step == 0)
+		{
+			auto scope = src_scope_new(self.src, stmt, typer_scope(self), false, nullptr);
+			typer_scope_enter(self, scope);
+		}
 
-		auto scope = src_scope_new(self.src, stmt, typer_scope(self), false, nullptr);
+		if(step < stmt->block_stmt.count)
+			return stmt->block_stmt[step];
 
-		typer_scope_enter(self, scope);
-		for (Stmt* s : stmt->block_stmt)
-			typer_stmt_resolve(self, s);
 		typer_scope_leave(self);
-
-		return type_void;
+		return nullptr;
 	}
 
-	inline static Type*
-	typer_stmt_resolve(Typer& self, Stmt* stmt)
+	inline static Stmt*
+	typer_stmt_visit(Typer& self, Stmt* stmt, size_t step)
 	{
 		switch(stmt->kind)
 		{
-		case Stmt::KIND_BREAK: return typer_stmt_break_resolve(self, stmt);
-		case Stmt::KIND_CONTINUE: return typer_stmt_continue_resolve(self, stmt);
-		case Stmt::KIND_RETURN: return typer_stmt_return_resolve(self, stmt);
-		case Stmt::KIND_IF: return typer_stmt_if_resolve(self, stmt);
-		case Stmt::KIND_FOR: return typer_stmt_for_resolve(self, stmt);
-		case Stmt::KIND_VAR: return typer_stmt_var_resolve(self, stmt);
-		case Stmt::KIND_ASSIGN: return typer_stmt_assign_resolve(self, stmt);
-		case Stmt::KIND_EXPR: return typer_stmt_expr_resolve(self, stmt);
-		case Stmt::KIND_BLOCK: return typer_anonymous_block_resolve(self, stmt);
-		default: assert(false && "unreachable"); return type_void;
+		case Stmt::KIND_BREAK: typer_stmt_break_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_CONTINUE: typer_stmt_continue_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_RETURN: typer_stmt_return_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_IF: return typer_stmt_if_visit(self, stmt, step);
+		case Stmt::KIND_FOR: return typer_stmt_for_visit(self, stmt, step);
+		case Stmt::KIND_VAR: typer_stmt_var_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_ASSIGN: typer_stmt_assign_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_EXPR: typer_stmt_expr_resolve(self, stmt); return nullptr;
+		case Stmt::KIND_BLOCK: return typer_stmt_anonymous_block_visit(self, stmt, step);
+		default: assert(false && "unreachable"); return nullptr;
 		}
 	}
 
+	inline static void
+	typer_stmt_resolve(Typer& self, Stmt* stmt)
+	{
+		stmt_walk(self.stmt_stack, stmt, self, typer_stmt_visit);
+	}
+
 
 	//terminate functions
+	//every branch has to terminate, the branches which are left to check wait on the stmt stack
 	inline static bool
 	typer_is_terminating(Typer& self, Stmt* stmt)
 	{
-		switch(stmt->kind)
-		{
-		case Stmt::KIND_BLOCK:
-			if (stmt->block_stmt.count == 0)
-				return false;
-			return typer_is_terminating(self, mn::buf_top(stmt->block_stmt));
-		case Stmt::KIND_RETURN:
-			return true;
-		case Stmt::KIND_FOR:
-			return typer_is_terminating(self, stmt->for_stmt.loop_body);
-		case Stmt::KIND_IF:
+		auto& stack = self.stmt_stack;
+		size_t base = stack.count;
+		mn::buf_push(stack, Stmt_Walk_Frame{stmt, 0});
+
+		bool res = true;
+		while(res && stack.count > base)
 		{
-			bool res = typer_is_terminating(self, stmt->if_stmt.if_body);
-			for (const Else_If& f : stmt->if_stmt.else_ifs)
-				res &= typer_is_terminating(self, f.body);
-			if (stmt->if_stmt.else_body)
-				res &= typer_is_terminating(self, stmt->if_stmt.else_body);
-			return res;
-		}
-		default:
-			return false;
+			Stmt* s = mn::buf_top(stack).stmt;
+			mn::buf_pop(stack);
+			switch(s->kind)
+			{
+			case Stmt::KIND_BLOCK:
+				if (s->block_stmt.count == 0)
+					res = false;
+				else
+					mn::buf_push(stack, Stmt_Walk_Frame{mn::buf_top(s->block_stmt), 0});
+				break;
+			case Stmt::KIND_RETURN:
+				break;
+			case Stmt::KIND_FOR:
+				mn::buf_push(stack, Stmt_Walk_Frame{s->for_stmt.loop_body, 0});
+				break;
+			case Stmt::KIND_IF:
+				mn::buf_push(stack, Stmt_Walk_Frame{s->if_stmt.if_body, 0});
+				for (const Else_If& f : s->if_stmt.else_ifs)
+					mn::buf_push(stack, Stmt_Walk_Frame{f.body, 0});
+				if (s->if_stmt.else_body)
+					mn::buf_push(stack, Stmt_Walk_Frame{s->if_stmt.else_body, 0});
+				break;
+			default:
+				res = false;
+				break;
+			}
 		}
+
+		mn::buf_resize(stack, base);
+		return res;
 	}
 
 
@@ -981,11 +1155,11 @@ namespace zay
 
 		for(const Arg& arg: decl->func_decl.args)
 		{
-			Type* type = typer_type_sign_resolve(self, arg.type, nullptr);
-			buf_pushn(sign.args, arg.ids.count, type);
+			Type* type = typer_type_sign_resolve(self, arg.type, nullptr, sign_use_tkn(arg.ids[0]));
+			small_buf_pushn(sign.args, arg.ids.count, type);
 		}
 
-		sign.ret = typer_type_sign_resolve(self, decl->func_decl.ret_type, nullptr);
+		sign.ret = typer_type_sign_resolve(self, decl->func_decl.ret_type, nullptr, sign_use_tkn(decl->name));
 		return type_intern_func(self.src->type_table, sign);
 	}
 
@@ -1014,8 +1188,11 @@ namespace zay
 			i += arg.ids.count;
 		}
 
+		// lazy bodies are parsed when they're reached, a body with syntax errors isn't typechecked
+		bool parsed = src_parse_func_body(self.src, decl);
+
 		// typecheck the function body if it exists
-		if (decl->func_decl.body)
+		if (decl->func_decl.body && parsed)
 		{
 			typer_stmt_block_resolve(self, decl->func_decl.body);
 
@@ -1036,11 +1213,11 @@ namespace zay
 	typer_decl_var_resolve(Typer& self, Sym* sym)
 	{
 		assert(sym->kind == Sym::KIND_VAR);
-		bool infer = sym->var_sym.type.count == 0;
+		bool infer = sym->var_sym.type == nullptr;
 
 		Type* type = type_void;
 		if(infer == false)
-			type = typer_type_sign_resolve(self, sym->var_sym.type, nullptr);
+			type = typer_type_sign_resolve(self, sym->var_sym.type, nullptr, sign_use_tkn(sym->var_sym.id));
 
 		Expr* e = sym->var_sym.expr;
 
@@ -1148,6 +1325,8 @@ namespace zay
 		self.scope_stack = mn::buf_new<Scope*>();
 		self.global_scope = src_scope_new(self.src, nullptr, nullptr, false, nullptr);
 		self.unnamed_id = 0;
+		self.expr_stack = mn::buf_new<Expr_Walk_Frame>();
+		self.stmt_stack = mn::buf_new<Stmt_Walk_Frame>();
 
 		typer_scope_enter(self, self.global_scope);
 		return self;
@@ -1157,6 +1336,8 @@ namespace zay
 	typer_free(Typer& self)
 	{
 		buf_free(self.scope_stack);
+		buf_free(self.expr_stack);
+		buf_free(self.stmt_stack);
 	}
 
 	void
@@ -1166,7 +1347,7 @@ namespace zay
 
 		if (self.mode == Typer::MODE_EXE)
 		{
-			const char* main = str_intern(self.src->str_table, "main");
+			const char* main = intern_pool_get(self.src->str_table, "main");
 			Sym* main_sym = nullptr;
 			for (size_t i = 0; i < self.global_scope->syms.count; ++i)
 			{
@@ -10,6 +10,7 @@
 #include <zay/Src.h>
 #include <zay/scan/Scanner.h>
 #include <zay/parse/Parser.h>
+#include <zay/parse/AST_Cache.h>
 #include <zay/typecheck/Typer.h>
 #include <zay/CGen.h>
 
@@ -18,13 +19,14 @@ zyc command [flags] PATH...
 
 COMMAND:
 help:  prints this message
-scan:  scans the given input
+scan:  scans the given input and prints all the tokens
 parse: parses the given input
 build: builds and generates the C code for the given input
 
 FLAGS:
 -output: specifies the output file
 -lib: changes the compiler mode from executable mode (default) to library mode
+-cache: specifies a folder to cache the parsed files in, unchanged files skip scanning and parsing
 )";
 
 struct Args
@@ -56,6 +58,7 @@ struct Args
 		{
 			mn::Str path;
 			mn::Str output;
+			mn::Str cache;
 		} build;
 	};
 };
@@ -85,6 +88,7 @@ args_free(Args* self)
 	case Args::KIND_BUILD:
 		mn::str_free(self->build.path);
 		mn::str_free(self->build.output);
+		mn::str_free(self->build.cache);
 		break;
 	default:
 		assert(false && "unreachable");
@@ -118,6 +122,22 @@ args_parse_flags(Args* self, int* i, int argc, char** argv)
 				break;
 			}
 		}
+		else if(flag == "-cache")
+		{
+			if(self->kind != Args::KIND_BUILD)
+			{
+				res = mn::Err{ "can't specify cache flag" };
+				break;
+			}
+
+			++(*i);
+			if(*i >= argc)
+			{
+				res = mn::Err{ "unspecified cache folder" };
+				break;
+			}
+			self->build.cache = mn::str_from_c(argv[*i]);
+		}
 		else
 		{
 			break;
@@ -244,16 +264,10 @@ main(int argc, char** argv)
 
 		auto src = zay::src_from_file(args.parse.path.ptr);
 		mn_defer(zay::src_free(src));
+		src->comments = zay::COMMENTS::TRIVIA;
 
-		//scan the file
-		if(zay::src_scan(src) == false)
-		{
-			mn::print("{}\n", zay::src_errs_dump(src, mn::memory::tmp()));
-			return 1;
-		}
-
-		//parse the file
-		if(zay::src_parse(src, zay::MODE::LIB) == false)
+		//scan and parse the file
+		if(zay::src_scan_parse(src, zay::MODE::LIB) == false)
 		{
 			mn::print("{}\n", zay::src_errs_dump(src, mn::memory::tmp()));
 			return 1;
@@ -272,17 +286,20 @@ main(int argc, char** argv)
 
 		auto src = zay::src_from_file(args.build.path.ptr);
 		mn_defer(zay::src_free(src));
-
-		//scan the file
-		if(zay::src_scan(src) == false)
-		{
-			mn::print("{}\n", zay::src_errs_dump(src, mn::memory::tmp()));
-			return 1;
-		}
+		//the parser never looks at the comments so don't pay for turning them into tokens
+		src->comments = zay::COMMENTS::TRIVIA;
+		//executables only typecheck what's reachable from main so the rest of the bodies are never parsed
+		if(args.lib == false)
+			src->bodies = zay::BODIES::LAZY;
 
 		auto parser_mode = args.lib ? zay::MODE::LIB : zay::MODE::EXE;
-		//parse the file
-		if(zay::src_parse(src, parser_mode) == false)
+		//scan and parse the file, the tokens are streamed into the parser
+		bool parsed = false;
+		if(args.build.cache.count > 0)
+			parsed = zay::src_scan_parse_cached(src, parser_mode, args.build.cache.ptr);
+		else
+			parsed = zay::src_scan_parse(src, parser_mode);
+		if(parsed == false)
 		{
 			mn::print("{}\n", zay::src_errs_dump(src, mn::memory::tmp()));
 			return 1;
@@ -307,4 +324,4 @@ main(int argc, char** argv)
 		return 1;
 	}
 	return 0;
-}
+}
\ No newline at end of file